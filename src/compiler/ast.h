@@ -216,6 +216,7 @@ struct Field : Node {
 	string name;
 	own<Action> initializer;
 	int offset = 0;
+	int opt_tag_offset = -1;  // ?int fields store their optional tags apart from values
 	weak<Class> cls;
 	DECLARE_DOM_CLASS(Field);
 };
@@ -224,6 +225,7 @@ struct Class : AbstractClass {
 	string name;
 	bool is_interface = false;
 	bool is_test = false;
+	bool is_json = false;  // has generated `toJson`/`fromJson` that handle only its own fields
 	bool is_defined = false;
 	bool used = false;  // instantiated, casted to, or has used descendants
 	weak<AbstractClass> base_class; // Class or ClassInstance
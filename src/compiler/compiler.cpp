@@ -94,6 +94,7 @@ int main(int argc, char* argv[]) {
     bool output_asm = false;
     bool add_debug_info = false;
     bool test_mode = false;
+    bool print_layouts = false;
     string start_module_name, out_file_name, opt_level;
     string entry_point_name = "main";
     for (auto arg = argv + 1, end = argv + argc; arg != end; arg++) {
@@ -118,7 +119,9 @@ int main(int argc, char* argv[]) {
                 "  -ON        : optimize 0-none, 1-less, 2-default, 3-aggressive\n"
                 "  -e fn_name : entry point fn name (default `main`)\n"
                 "  -T         : build tests\n"
-                "  -S         : output asm file\n";
+                "  -S         : output asm file\n"
+                "  -layouts   : print class sizes before and after field reordering\n"
+                "               (classes of modules with native functions keep their declared layout)\n";
             return 0;
         } else if (strcmp(*arg, "-S") == 0) {
             output_asm = true;
@@ -134,6 +137,8 @@ int main(int argc, char* argv[]) {
             entry_point_name = param();
         } else if (strcmp(*arg, "-T") == 0) {
             test_mode = true;
+        } else if (strcmp(*arg, "-layouts") == 0) {
+            print_layouts = true;
         } else if (strcmp(*arg, "-o") == 0) {
             out_file_name = param();
         } else if (strcmp(*arg, "-start") == 0) {
@@ -171,7 +176,7 @@ int main(int argc, char* argv[]) {
     llvm::InitializeAllTargets();
     llvm::InitializeAllTargetMCs();
     llvm::InitializeAllAsmPrinters();
-    auto threadsafe_module = generate_code(ast, add_debug_info, test_mode, entry_point_name);
+    auto threadsafe_module = generate_code(ast, add_debug_info, test_mode, entry_point_name, print_layouts);
     threadsafe_module.withModuleDo([&](llvm::Module& module) {
         std::error_code err_code;
         llvm::raw_fd_ostream out_file(out_file_name, err_code, llvm::sys::fs::OF_None);
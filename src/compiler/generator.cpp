@@ -255,9 +255,12 @@ struct Generator : ast::ActionScanner {
 	llvm::Constant* const_256 = nullptr;
 	llvm::Constant* const_ctr_step = nullptr;
 	llvm::Constant* const_ctr_static = nullptr;  // SHARED|MT|0
-	llvm::Constant* const_ctr_str_literal = nullptr;  // SHARED|MT|HASH|0
 	llvm::Constant* const_null_ptr = nullptr;
 	unordered_map<string, llvm::GlobalVariable*> string_literals;
+	unordered_map<weak<ast::Var>, llvm::Constant*> static_consts;  // null if const needs run-time initialization
+	unordered_set<pin<ast::Class>> special_copy_and_dispose;  // runtime-implemented classes
+	unordered_map<pin<ast::Method>, llvm::Type*> inlined_item_access;  // not overridden getAt/setAt of typed arrays -> item type
+	bool print_layouts = false;
 	unordered_map<
 		vector<llvm::Constant*>,
 		llvm::Constant*,
@@ -266,7 +269,7 @@ struct Generator : ast::ActionScanner {
 	Generator(ltm::pin<ast::Ast> ast, bool debug_info_mode)
 		: ast(ast)
 		, context(new llvm::LLVMContext)
-		, layout("")
+		, layout("i64:64")  // as on all 64-bit targets, llvm default aligns i64 to 4 and makes instance sizes too small
 	{
 		module = std::make_unique<llvm::Module>("code", *context);
 		if (debug_info_mode)
@@ -294,7 +297,6 @@ struct Generator : ast::ActionScanner {
 		const_256 = llvm::ConstantInt::get(tp_int_ptr, 256);
 		const_ctr_step = llvm::ConstantInt::get(tp_int_ptr, AG_CTR_STEP);
 		const_ctr_static = llvm::ConstantInt::get(tp_int_ptr, AG_CTR_SHARED | AG_CTR_MT);
-		const_ctr_str_literal = llvm::ConstantInt::get(tp_int_ptr, AG_CTR_SHARED | AG_CTR_MT | AG_CTR_HASH);
 		const_null_ptr = llvm::ConstantPointerNull::get(ptr_type);
 
 		fn_dispose = llvm::Function::Create(
@@ -560,13 +562,23 @@ struct Generator : ast::ActionScanner {
 			if (c == ast->string_cls) {
 				di_fields.push_back(di_builder->createMemberType(
 					di_cu,
-					"text",
+					"size",
 					di_cu->getFile(),
 					0,  // line
 					layout.getPointerSizeInBits(),
 					0,  // align
 					struct_layout->getElementOffsetInBits(i),
 					llvm::DINode::DIFlags::FlagZero,
+					di_int));
+				di_fields.push_back(di_builder->createMemberType(
+					di_cu,
+					"text",
+					di_cu->getFile(),
+					0,  // line
+					layout.getPointerSizeInBits(),
+					0,  // align
+					struct_layout->getElementOffsetInBits(i + 1),
+					llvm::DINode::DIFlags::FlagZero,
 					di_builder->createBasicType("asciiz", 8, llvm::dwarf::DW_ATE_UTF)));
 			} else if (c == ast->own_array->base_class) { // container, add no fields
 			} else if (c == ast->own_array || c == ast->weak_array || c == ast->blob) {
@@ -608,7 +620,7 @@ struct Generator : ast::ActionScanner {
 						layout.getPointerSizeInBits())));
 			} else {
 				for (auto& f : c->fields) {
-					auto field_type = ci.fields->getElementType(i);
+					auto field_type = ci.fields->getElementType(f->offset);
 					di_fields.push_back(di_builder->createMemberType(
 						di_cu,
 						f->name,
@@ -616,10 +628,9 @@ struct Generator : ast::ActionScanner {
 						0,  // line
 						layout.getTypeSizeInBits(field_type),
 						0,  // align: layout.getABITypeAlign(field_type).value() * 8,
-						struct_layout->getElementOffsetInBits(i),
+						struct_layout->getElementOffsetInBits(f->offset),
 						llvm::DINode::DIFlags::FlagZero,
-						to_di_type(*f->initializer->type())));
-					i++;
+						f->opt_tag_offset < 0 ? to_di_type(*f->initializer->type()) : di_int));
 				}
 			}
 			di_builder->replaceArrays(ci.di_cls, di_builder->getOrCreateArray(move(di_fields)));
@@ -892,27 +903,127 @@ struct Generator : ast::ActionScanner {
 	void on_const_void(ast::ConstVoid&) override { result->data = llvm::UndefValue::get(void_type); }
 	void on_const_bool(ast::ConstBool& node) override { result->data = builder->getInt1(node.value); }
 	void on_const_string(ast::ConstString& node) override {
+		result->data = get_str_literal(node);
+		result->lifetime = Val::Static{};
+	}
+	llvm::GlobalVariable* get_str_literal(ast::ConstString& node) {
 		auto& str = string_literals[node.value];
 		if (!str) {
 			auto str_name = ast::format_str("ag_str_", &node);
 			auto& cls = classes.at(ast->string_cls);
 			llvm::Constant* str_constant = llvm::ConstantDataArray::getString(*context, node.value);
-			auto* str_type = llvm::StructType::get(obj_struct, str_constant->getType());
+			auto* str_type = llvm::StructType::get(obj_struct, int_type, str_constant->getType());
 			module->getOrInsertGlobal(str_name, str_type);
 			str = module->getGlobalVariable(str_name);
 			vector<llvm::Constant*> obj_fields = {
 				llvm::ConstantExpr::getBitCast(cls.dispatcher, ptr_type),
-				const_ctr_str_literal, // shared|mt|hash|0
-				llvm::ConstantInt::get(tp_int_ptr, ag_getStringHash(node.value.c_str()) | 1) };    // parent/weak/hash field
+				const_ctr_static, // shared|mt|0, hash is seeded per process and gets cached by `ag_fn_sys_hash`
+				const_1 };        // parent/weak/hash field
 			str->setInitializer(
 				llvm::ConstantStruct::get(str_type, {
 					llvm::ConstantStruct::get(obj_struct, obj_fields),
+					llvm::ConstantInt::get(int_type, node.value.size()),
 					str_constant
 				}));
 			str->setLinkage(llvm::GlobalValue::InternalLinkage);
 		}
-		result->data = str;
-		result->lifetime = Val::Static{};
+		return str;
+	}
+
+	// Evaluates const initializer at compile time.
+	// Returns null if initializer is not pure and needs to be executed at startup.
+	llvm::Constant* make_static_const(ast::Action& node) {
+		struct Evaluator : ast::ActionMatcher {
+			Generator& gen;
+			llvm::Constant* result = nullptr;
+			Evaluator(Generator& gen) : gen(gen) {}
+			void on_const_i32(ast::ConstInt32& node) override { result = llvm::ConstantInt::get(gen.int32_type, node.value); }
+			void on_const_i64(ast::ConstInt64& node) override { result = llvm::ConstantInt::get(gen.int_type, node.value); }
+			void on_const_enum_tag(ast::ConstEnumTag& node) override { result = llvm::ConstantInt::get(gen.int_type, node.value->val); }
+			void on_const_float(ast::ConstFloat& node) override { result = llvm::ConstantFP::get(gen.float_type, node.value); }
+			void on_const_double(ast::ConstDouble& node) override { result = llvm::ConstantFP::get(gen.double_type, node.value); }
+			void on_const_bool(ast::ConstBool& node) override { result = llvm::ConstantInt::get(gen.tp_bool, node.value); }
+			void on_const_string(ast::ConstString& node) override {
+				result = llvm::ConstantExpr::getBitCast(gen.get_str_literal(node), gen.ptr_type);
+			}
+			void on_get(ast::Get& node) override {
+				if (node.var->is_const)
+					result = gen.get_static_const(node.var);
+			}
+			void on_cast(ast::CastOp& node) override {
+				if (!node.p[1] && gen.is_ptr(node.type()))
+					result = gen.make_static_const(*node.p[0]);
+			}
+			void on_freeze(ast::FreezeOp& node) override {
+				if (auto obj = gen.make_static_object(node.p))
+					result = llvm::ConstantExpr::getBitCast(obj, gen.ptr_type);
+			}
+		} evaluator(*this);
+		node.match(evaluator);
+		return evaluator.result;
+	}
+	llvm::Constant* get_static_const(weak<ast::Var> var) {
+		if (auto it = static_consts.find(var); it != static_consts.end())
+			return it->second;
+		static_consts[var] = nullptr;  // breaks reference loops
+		return static_consts[var] = make_static_const(*var->initializer);
+	}
+	// Makes a static frozen object out of `Cls` or `Cls.{ _.field := const; ... }`.
+	llvm::Constant* make_static_object(own<ast::Action>& node) {
+		auto instance = dom::strict_cast<ast::MkInstance>(node);
+		auto block = dom::strict_cast<ast::Block>(node);
+		if (block) {
+			if (block->names.size() != 1 || block->body.empty())
+				return nullptr;
+			auto ret = dom::strict_cast<ast::Get>(block->body.back());
+			if (!ret || ret->var != block->names.front())
+				return nullptr;
+			instance = dom::strict_cast<ast::MkInstance>(block->names.front()->initializer);
+		}
+		if (!instance || !instance->cls || instance->cls->inst_mode() != ast::AbstractClass::InstMode::direct)
+			return nullptr;
+		auto cls = instance->cls->get_implementation();
+		auto& info = classes.at(cls);
+		vector<llvm::Constant*> fields(info.fields->getNumElements(), nullptr);
+		fields[0] = llvm::ConstantExpr::getBitCast(info.dispatcher, ptr_type);
+		fields[1] = const_ctr_static;
+		fields[2] = llvm::ConstantInt::get(tp_int_ptr, AG_F_PARENT);  // no parent, no weak
+		auto set_field = [&](ast::Field& field, ast::Action& val) {
+			auto type = field.initializer->type();
+			if (is_ptr(type) && !isa<ast::TpShared>(*type))
+				return false;
+			auto r = make_static_const(val);
+			if (!r || r->getType() != info.fields->getElementType(field.offset))
+				return false;
+			fields[field.offset] = r;
+			return true;
+		};
+		for (pin<ast::Class> c = cls; c; c = c->base_class ? c->base_class->get_implementation() : nullptr) {
+			if (c == ast->string_cls ||
+				special_copy_and_dispose.count(c) ||
+				c->module->functions.count("dispose" + c->name))
+				return nullptr;
+			for (auto& f : c->fields) {
+				if (!set_field(*f, *f->initializer))
+					return nullptr;
+			}
+		}
+		if (block) {
+			for (auto i = block->body.begin(), last = block->body.end() - 1; i != last; ++i) {
+				auto set = dom::strict_cast<ast::SetField>(*i);
+				if (!set)
+					return nullptr;
+				auto base = dom::strict_cast<ast::Get>(set->base);
+				if (!base || base->var != block->names.front() || !set_field(*set->field.pinned(), *set->val))
+					return nullptr;
+			}
+		}
+		auto name = ast::format_str("ag_obj_", &*node);
+		module->getOrInsertGlobal(name, info.fields);
+		auto obj = module->getGlobalVariable(name);
+		obj->setInitializer(llvm::ConstantStruct::get(info.fields, fields));
+		obj->setLinkage(llvm::GlobalValue::InternalLinkage);
+		return obj;
 	}
 
 	unordered_map<ast::Type*, llvm::DISubroutineType*> di_fn_types;
@@ -1160,6 +1271,8 @@ struct Generator : ast::ActionScanner {
 			builder->CreateCall(fn_init, {});
 			for (auto& m : ast->modules_in_order) {
 				for (auto& c : m->constants) {
+					if (static_consts[c.second])
+						continue;
 					auto addr = globals[c.second];
 					auto val = compile(c.second->initializer);
 					make_retained_or_non_ptr(val);
@@ -1195,12 +1308,13 @@ struct Generator : ast::ActionScanner {
 		auto fn_result = compile(node.body.back());
 		persist_rfield(fn_result);
 		if (fn_type->can_x_break) {
-			if (auto as_opt = dom::strict_cast<ast::TpOptional>(result_type))
-				fn_result.data = make_opt_val(fn_result.data, as_opt);
-			else
+			if (auto as_opt = dom::strict_cast<ast::TpOptional>(result_type)) {
+				fn_result.data = make_opt_val(fn_result.data, as_opt);  // keeps lifetime, temps get retained by `release_params`
+			} else {
 				fn_result.data = nullptr;
+				fn_result.lifetime = Val::Static{};
+			}
 			fn_result.type = result_type;
-			fn_result.lifetime = Val::Static{};
 		}
 		if (isa<ast::TpVoid>(*result_type)) {
 			fn_result.data = nullptr;
@@ -1540,6 +1654,40 @@ struct Generator : ast::ActionScanner {
 		result->data = functions.at(node.fn);
 	}
 
+	// Bounds-checked typed array getAt/setAt without call, so loops over arrays can be optimized and vectorized.
+	// Out-of-bounds getAt returns 0, setAt does nothing, as their runtime versions do.
+	llvm::Value* build_typed_array_item_access(ast::Method& method, llvm::Type* item_type, vector<llvm::Value*>& params) {
+		auto class_fields = classes.at(method.cls).fields;
+		auto& count_field = *method.cls->fields[0];
+		auto& items_field = *method.cls->fields[1];
+		auto index = params[1];
+		auto bb_entry = builder->GetInsertBlock();
+		auto bb_in_bounds = llvm::BasicBlock::Create(*context, "", current_ll_fn);
+		auto bb_done = llvm::BasicBlock::Create(*context, "", current_ll_fn);
+		builder->CreateCondBr(
+			builder->CreateICmpULT(index, load_field(class_fields, params[0], count_field)),
+			bb_in_bounds,
+			bb_done);
+		builder->SetInsertPoint(bb_in_bounds);
+		auto item_ptr = builder->CreateGEP(
+			item_type,
+			builder->CreateLoad(ptr_type, builder->CreateStructGEP(class_fields, params[0], items_field.offset)),
+			{ index });
+		llvm::Value* item = nullptr;
+		if (params.size() == 2)
+			item = builder->CreateLoad(item_type, item_ptr);
+		else
+			builder->CreateStore(params[2], item_ptr);
+		builder->CreateBr(bb_done);
+		builder->SetInsertPoint(bb_done);
+		if (!item)
+			return llvm::UndefValue::get(void_type);
+		auto phi = builder->CreatePHI(item_type, 2);
+		phi->addIncoming(llvm::Constant::getNullValue(item_type), bb_entry);
+		phi->addIncoming(item, bb_in_bounds);
+		return phi;
+	}
+
 	void on_call(ast::Call& node) override {
 		vector<llvm::Value*> params;
 		vector<pair<Val, size_t>> to_dispose; // val and active_breaks_mark at the moment val is succeeded
@@ -1575,7 +1723,9 @@ struct Generator : ast::ActionScanner {
 				).data;
 			}
 			params.front() = cast_to(receiver, ptr_type);
-			if (method->cls->is_interface) {
+			if (auto item_type = inlined_item_access.find(method); item_type != inlined_item_access.end()) {
+				result->data = build_typed_array_item_access(*method, item_type->second, params);
+			} else if (method->cls->is_interface) {
 				auto entry_point = builder->CreateCall(
 					llvm::FunctionCallee(
 						dispatcher_fn_type,
@@ -2013,6 +2163,10 @@ struct Generator : ast::ActionScanner {
 			capture_offsets[var]);
 	}
 	void on_get(ast::Get& node) override {
+		if (auto it = static_consts.find(node.var); it != static_consts.end() && it->second) {
+			result->data = it->second;
+			return;
+		}
 		result->data = remove_indirection(*node.var.pinned(), get_data_ref(node.var));
 		if (is_ptr(node.type()) && !node.var->is_const)
 			result->lifetime = Val::Temp{ node.var };
@@ -2030,12 +2184,90 @@ struct Generator : ast::ActionScanner {
 			builder->CreateStore(result->data, get_data_ref(node.var));
 		}
 	}
+	size_t get_fields_size(const vector<llvm::Type*>& fields, const vector<pair<llvm::Type*, int*>>& slots) {
+		vector<llvm::Type*> all = fields;
+		for (auto& slot : slots)
+			all.push_back(slot.first);
+		return layout.getTypeAllocSize(llvm::StructType::get(*context, all));
+	}
+	// Modules having platform (bodyless) functions or methods are bound to C code, that mirrors their classes as C structs.
+	bool has_native_code(ast::Module& module) {
+		for (auto& f : module.functions)
+			if (f.second->is_platform)
+				return true;
+		for (auto& c : module.classes) {
+			for (auto& m : c.second->new_methods)
+				if (m->is_platform)
+					return true;
+			for (auto& b : c.second->overloads)
+				for (auto& m : b.second)
+					if (m->is_platform)
+						return true;
+		}
+		return false;
+	}
+	// Reorders class fields to minimize padding. At each position it takes the most aligned field that needs no padding.
+	// Reordering happens only if it makes class smaller, so homogeneous classes keep their declaration order.
+	// Classes of `sys` and of the modules with native code are never reordered, as their layouts must match C structs.
+	void pack_fields(const vector<llvm::Type*>& fields, vector<pair<llvm::Type*, int*>>& slots) {
+		auto align_of = [&](llvm::Type* t) { return uint64_t(layout.getABITypeAlign(t).value()); };
+		auto align_to = [](uint64_t offset, uint64_t align) { return (offset + align - 1) / align * align; };
+		uint64_t offset = 0;
+		for (auto f : fields)
+			offset = align_to(offset, align_of(f)) + layout.getTypeAllocSize(f);
+		vector<pair<llvm::Type*, int*>> packed;
+		auto rest = slots;
+		while (!rest.empty()) {
+			auto best = rest.begin();
+			bool best_fits = false;
+			for (auto i = rest.begin(); i != rest.end(); ++i) {
+				auto align = align_of(i->first);
+				bool fits = offset % align == 0;
+				if ((fits && !best_fits) || (fits == best_fits && align > align_of(best->first))) {
+					best = i;
+					best_fits = fits;
+				}
+			}
+			offset = align_to(offset, align_of(best->first)) + layout.getTypeAllocSize(best->first);
+			packed.push_back(*best);
+			rest.erase(best);
+		}
+		if (get_fields_size(fields, packed) < get_fields_size(fields, slots))
+			slots = move(packed);
+	}
+	// Fields of type ?int are stored as int value and i8 tag, to avoid the padding of {i8, i64} struct.
+	// Tags are placed after all fields of a class level, or in the padding holes.
+	bool is_split_opt_field(ast::Field& field) {
+		auto as_opt = dom::strict_cast<ast::TpOptional>(field.initializer->type());
+		return as_opt && isa<ast::TpInt64>(*as_opt->wrapped);
+	}
+	llvm::Value* load_field(llvm::StructType* class_fields, llvm::Value* base, ast::Field& field) {
+		auto val = builder->CreateLoad(
+			class_fields->getElementType(field.offset),
+			builder->CreateStructGEP(class_fields, base, field.offset));
+		if (field.opt_tag_offset < 0)
+			return val;
+		return builder->CreateInsertValue(
+			builder->CreateInsertValue(
+				llvm::UndefValue::get(tp_opt_int),
+				builder->CreateLoad(tp_opt_bool, builder->CreateStructGEP(class_fields, base, field.opt_tag_offset)),
+				{ 0 }),
+			val,
+			{ 1 });
+	}
+	void store_field(llvm::StructType* class_fields, llvm::Value* base, ast::Field& field, llvm::Value* val) {
+		if (field.opt_tag_offset >= 0) {
+			builder->CreateStore(
+				builder->CreateExtractValue(val, { 0 }),
+				builder->CreateStructGEP(class_fields, base, field.opt_tag_offset));
+			val = builder->CreateExtractValue(val, { 1 });
+		}
+		builder->CreateStore(val, builder->CreateStructGEP(class_fields, base, field.offset));
+	}
 	void on_get_field(ast::GetField& node) override {
 		auto base = compile(node.base);
 		auto class_fields = classes.at(ast->extract_class(base.type)->get_implementation()).fields;
-		result->data = builder->CreateLoad(
-			class_fields->getElementType(node.field->offset),
-			builder->CreateStructGEP(class_fields, base.data, node.field->offset));
+		result->data = load_field(class_fields, base.data, *node.field.pinned());
 		if (is_ptr(node.type())) {
 			if (get_if<Val::Retained>(&base.lifetime)) {
 				result->lifetime = Val::RField{ base.data };
@@ -2075,12 +2307,7 @@ struct Generator : ast::ActionScanner {
 			*result = compile(node.val);
 			make_retained_or_non_ptr(*result);
 			auto base = compile(node.base);
-			builder->CreateStore(
-				result->data,
-				builder->CreateStructGEP(
-					class_fields,
-					base.data,
-					node.field->offset));
+			store_field(class_fields, base.data, *node.field.pinned(), result->data);
 			dispose_val(base, active_breaks.size());
 		}
 	}
@@ -3046,7 +3273,7 @@ struct Generator : ast::ActionScanner {
 	}
 
 	llvm::orc::ThreadSafeModule build(bool test_mode, string entry_point_name) {
-		std::unordered_set<pin<ast::Class>> special_copy_and_dispose = {
+		special_copy_and_dispose = {
 			ast->blob,
 			ast->own_array,
 			ast->weak_array,
@@ -3055,7 +3282,43 @@ struct Generator : ast::ActionScanner {
 			ast->modules["sys"]->peek_class("Map"),
 			ast->modules["sys"]->peek_class("SharedMap"),
 			ast->modules["sys"]->peek_class("WeakMap"),
+			ast->modules["sys"]->peek_class("IntMap"),
+			ast->modules["sys"]->peek_class("SharedIntMap"),
+			ast->modules["sys"]->peek_class("WeakIntMap"),
+			ast->modules["sys"]->peek_class("IntSet"),
+			ast->modules["sys"]->peek_class("SortedIntMap"),
+			ast->modules["sys"]->peek_class("SharedSortedIntMap"),
+			ast->modules["sys"]->peek_class("WeakSortedIntMap"),
+			ast->modules["sys"]->peek_class("SortedIntSet"),
+			ast->modules["sys"]->peek_class("SortedStrMap"),
+			ast->modules["sys"]->peek_class("SharedSortedStrMap"),
+			ast->modules["sys"]->peek_class("WeakSortedStrMap"),
+			ast->modules["sys"]->peek_class("SortedStrSet"),
+			ast->modules["sys"]->peek_class("PriorityQueue"),
+			ast->modules["sys"]->peek_class("DoublePriorityQueue"),
+			ast->modules["sys"]->peek_class("Deque"),
+			ast->modules["sys"]->peek_class("SharedDeque"),
+			ast->modules["sys"]->peek_class("WeakDeque"),
 		};
+		for (auto& [name, item_type] : std::initializer_list<pair<const char*, llvm::Type*>>{
+			{ "Int32Array", int32_type },
+			{ "Int64Array", int_type },
+			{ "FloatArray", float_type },
+			{ "DoubleArray", double_type }})
+		{
+			auto cls = ast->modules["sys"]->peek_class(name);
+			special_copy_and_dispose.insert(cls);
+			for (auto& m : cls->new_methods) {
+				if (m->name == "getAt" || m->name == "setAt")
+					inlined_item_access[m] = item_type;
+			}
+		}
+		for (auto& cls : ast->classes_in_order) {
+			for (auto& base_and_methods : cls->overloads) {
+				for (auto& m : base_and_methods.second)
+					inlined_item_access.erase(m->ovr.pinned());
+			}
+		}
 		dispatcher_fn_type = llvm::FunctionType::get(ptr_type, { int_type }, false);
 		auto dispose_fn_type = llvm::FunctionType::get(void_type, { ptr_type }, false);
 		auto copier_fn_type = llvm::FunctionType::get(
@@ -3179,12 +3442,33 @@ struct Generator : ast::ActionScanner {
 				fields.push_back(tp_int_ptr);  // counter
 				fields.push_back(tp_int_ptr);  // weak/parent
 			}
+			vector<pair<llvm::Type*, int*>> slots;  // type and where to store its index
 			for (auto& field : cls->fields) {
-				field->offset = fields.size();
-				fields.push_back(to_llvm_type(*field->initializer->type()));
+				if (is_split_opt_field(*field)) {
+					slots.push_back({ int_type, &field->offset });
+				} else {
+					field->opt_tag_offset = -1;
+					slots.push_back({ to_llvm_type(*field->initializer->type()), &field->offset });
+				}
 			}
-			if (cls == ast->string_cls)
+			for (auto& field : cls->fields) {
+				if (is_split_opt_field(*field))
+					slots.push_back({ tp_opt_bool, &field->opt_tag_offset });
+			}
+			auto declared_size = get_fields_size(fields, slots);
+			bool has_c_counterpart = cls->module->name == "sys" || has_native_code(*cls->module.pinned());
+			if (!has_c_counterpart)
+				pack_fields(fields, slots);
+			if (print_layouts && !has_c_counterpart)
+				llvm::outs() << "layout " << cls->get_name() << ": " << declared_size << " -> " << get_fields_size(fields, slots) << " bytes\n";
+			for (auto& slot : slots) {
+				*slot.second = int(fields.size());
+				fields.push_back(slot.first);
+			}
+			if (cls == ast->string_cls) {  // AgString size and chars
+				fields.push_back(int_type);
 				fields.push_back(llvm::Type::getInt8Ty(*context));
+			}
 			info.fields->setBody(fields);
 		}
 		make_di_clases();
@@ -3243,6 +3527,15 @@ struct Generator : ast::ActionScanner {
 				globals.insert({ c.second, addr });
 			}
 		}
+		for (auto& m : ast->modules_in_order) {
+			for (auto& c : m->constants) {
+				if (auto val = get_static_const(c.second)) {
+					auto addr = llvm::cast<llvm::GlobalVariable>(globals.at(c.second));
+					addr->setInitializer(val);
+					addr->setConstant(true);
+				}
+			}
+		}
 		for (auto& m : ast->modules) {
 			for (auto& fn : m.second->functions) {
 				if (!fn.second->used)
@@ -3286,9 +3579,7 @@ struct Generator : ast::ActionScanner {
 			for (auto& field : cls->fields) {
 				auto initializer = compile(field->initializer);
 				make_retained_or_non_ptr(initializer, result);
-				builder.CreateStore(
-					initializer.data,
-					builder.CreateStructGEP(info.fields, result, field->offset));
+				store_field(info.fields, result, *field, initializer.data);
 			}
 			builder.CreateRetVoid();
 			// Constructor
@@ -3557,8 +3848,9 @@ struct Generator : ast::ActionScanner {
 	}
 };
 
-llvm::orc::ThreadSafeModule generate_code(ltm::pin<ast::Ast> ast, bool add_debug_info, bool test_mode, string entry_point_name) {
+llvm::orc::ThreadSafeModule generate_code(ltm::pin<ast::Ast> ast, bool add_debug_info, bool test_mode, string entry_point_name, bool print_layouts) {
 	Generator gen(ast, add_debug_info);
+	gen.print_layouts = print_layouts;
 	return gen.build(test_mode, entry_point_name);
 }
 
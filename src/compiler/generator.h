@@ -8,7 +8,8 @@ llvm::orc::ThreadSafeModule generate_code(
     ltm::pin<ast::Ast> ast,
     bool add_debug_info,
     bool test_mode,
-    std::string entry_point_name);
+    std::string entry_point_name,
+    bool print_layouts = false);  // prints class sizes before and after field reordering
 
 int64_t execute(llvm::orc::ThreadSafeModule module, bool dump_ir = false);
 
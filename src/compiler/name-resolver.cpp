@@ -50,6 +50,8 @@ struct NameResolver : ast::ActionScanner {
 				c->error("there might be only one base class in ", c->get_name());
 			} else if (c->is_interface) {
 				c->error("interface ", c->get_name(), " cannot extend class ", abstract_base.first->get_name());
+			} else if (c->is_json) {
+				c->error("@json class ", c->get_name(), " cannot extend class ", abstract_base.first->get_name());
 			} else {
 				c->base_class = abstract_base.first->get_implementation();
 			}
@@ -184,8 +186,16 @@ struct NameResolver : ast::ActionScanner {
 				}
 			}
 			this_class = nullptr;
-			for (auto& f : c->fields)
+			for (auto& f : c->fields) {
+				// Parser generates `toJson`/`fromJson` calls for `@json` fields initialized with names, they must be classes
+				bool is_json_object = c->is_json && dom::isa<ast::Get>(*strip_neg(f->initializer));
 				fix(f->initializer);
+				if (is_json_object) {
+					auto mk_instance = dom::strict_cast<ast::MkInstance>(strip_neg(f->initializer));
+					if (!mk_instance || !mk_instance->cls || dom::isa<ast::ClassParam>(*mk_instance->cls.pinned()))
+						f->error("@json class ", c->get_name(), " field ", f->name, " must be initialized with a class");
+				}
+			}
 			this_class = c;
 			for (auto& m : c->new_methods)
 				fix_fn(m);
@@ -205,6 +215,11 @@ struct NameResolver : ast::ActionScanner {
 				fix(m.second->entry_point);
 		}
 	}
+	static pin<ast::Action> strip_neg(pin<ast::Action> action) {
+		if (auto neg = dom::strict_cast<ast::NegOp>(action))
+			return neg->p;
+		return action;
+	}
 	void fix_fn(pin<ast::Function> fn) {
 		this_var = dom::isa<ast::Method>(*fn) || dom::isa<ast::ImmediateDelegate>(*fn)
 			? fn->names.front().pinned()
@@ -11,6 +11,7 @@
 #include <optional>
 #include <cfenv>
 #include <cmath>
+#include <cstdlib>
 #include "utils/utf8.h"
 
 namespace {
@@ -109,6 +110,94 @@ struct Parser {
 		return method;
 	}
 
+	// Parses a method from generated text as if it were written in the class body at the class location.
+	void add_generated_method(pin<ast::Class> cls, const string& text, ast::Mut mut) {
+		auto saved_cur = cur;
+		auto saved_line = line;
+		auto saved_pos = pos;
+		cur = text.c_str();
+		line = cls->line;
+		pos = cls->pos;
+		match_ws();
+		auto name = expect_id("generated method name");
+		cls->new_methods.push_back(make_method({ name, module }, cls, false));
+		cls->new_methods.back()->mut = mut;
+		if (*cur)
+			error("internal error, unexpected text in generated method ", name);
+		cur = saved_cur;
+		line = saved_line;
+		pos = saved_pos;
+	}
+
+	// Adds `toJson(json_Writer)` and `fromJson(json_Parser)` methods to a `@json` class.
+	// Field kinds are inferred from initializers: numeric, bool and string constants,
+	// nested classes and `Array(Class)`; the nested classes need `toJson`/`fromJson` too.
+	// `fromJson` finds field indices with `sys_keyIndex` that uses a perfect hash over the cached
+	// string hashes, it depends on the process hash seed and gets built at runtime.
+	void add_json_methods(pin<ast::Class> cls, const vector<std::pair<pin<ast::Field>, string>>& fields) {
+		if (module->direct_imports.count("json") == 0)
+			error("@json class ", cls->name, " requires `using json;`");
+		string to_json = "toJson(jsW json_Writer) json_Writer { jsW.obj `jsF {";
+		vector<string> readers;
+		for (auto& [field, init_text] : fields) {
+			auto& n = field->name;
+			if (n.size() == 3 && n.compare(0, 2, "js") == 0 && string("WFPAIH").find(n[2]) != string::npos)
+				error("@json class ", cls->name, " field ", n, " clashes with generated locals");
+			pin<Action> init = field->initializer;
+			if (auto neg = dom::strict_cast<ast::NegOp>(init))
+				init = neg->p;
+			auto first = init_text.find_first_not_of(" \t\r\n");
+			auto last = init_text.find_last_not_of(" \t\r\n");
+			auto text = first == string::npos ? string() : init_text.substr(first, last - first + 1);
+			if (dom::isa<ast::ConstDouble>(*init)) {
+				to_json += " jsF(\"" + n + "\").num(" + n + ");";
+				readers.push_back(n + " := jsP.getNum(" + n + ");");
+			} else if (dom::isa<ast::ConstFloat>(*init)) {
+				to_json += " jsF(\"" + n + "\").num(double(" + n + "));";
+				readers.push_back(n + " := float(jsP.getNum(double(" + n + ")));");
+			} else if (dom::isa<ast::ConstInt64>(*init)) {
+				to_json += " jsF(\"" + n + "\").num(double(" + n + "));";
+				readers.push_back(n + " := int(jsP.getNum(double(" + n + ")));");
+			} else if (dom::isa<ast::ConstInt32>(*init)) {
+				to_json += " jsF(\"" + n + "\").num(double(" + n + "));";
+				readers.push_back(n + " := short(jsP.getNum(double(" + n + ")));");
+			} else if (dom::isa<ast::ConstBool>(*init)) {
+				to_json += " jsF(\"" + n + "\").bool(" + n + ");";
+				readers.push_back(n + " := jsP.getBool(" + n + ");");
+			} else if (dom::isa<ast::ConstString>(*init)) {
+				to_json += " jsF(\"" + n + "\").str(" + n + ");";
+				readers.push_back(n + " := jsP.getStr(" + n + ");");
+			} else if (text.rfind("Array(", 0) == 0 && text.back() == ')') {
+				to_json += " jsF(\"" + n + "\").arr `jsA { jsI = 0; loop !{ jsI < " + n + ".size() ? { " + n + "[jsI] ? _.toJson(jsA); jsI += 1 } } };";
+				readers.push_back("jsP.getArr\\{ " + n + ".append(" + text.substr(6, text.size() - 7) + ").fromJson(jsP); };");
+			} else if (dom::isa<ast::Get>(*init)) {  // nested class, name resolver reports other names
+				to_json += " " + n + ".toJson(jsF(\"" + n + "\"));";
+				readers.push_back(n + ".fromJson(jsP);");
+			} else {
+				error("@json class ", cls->name, " field ", n, " must be initialized with a number, bool, string, class or Array(class)");
+			}
+		}
+		add_generated_method(cls, to_json + " }; jsW }", ast::Mut::ANY);
+		string from_json = "fromJson(jsP json_Parser) this {";
+		if (fields.empty()) {
+			from_json += " jsP.skipValue();";
+		} else if (fields.size() == 1) {
+			from_json += " jsP.getObj `jsF { jsF == \"" + fields[0].first->name + "\" ? { " + readers[0] + " }; };";
+		} else {
+			string names;
+			for (auto& f : fields)
+				names += (names.empty() ? "" : " ") + f.first->name;
+			from_json += " jsP.getObj `jsF { jsH = sys_keyIndex(jsF, \"" + names + "\");";
+			const char* separator = " ";
+			for (size_t i = 0; i < fields.size(); i++) {
+				from_json += ast::format_str(separator, "jsH == ", i, " ? { ", readers[i], " }");
+				separator = " : ";
+			}
+			from_json += "; };";
+		}
+		add_generated_method(cls, from_json + " }", ast::Mut::MUTATING);
+	}
+
 	ast::LongName expect_long_name(const char* message, pin<ast::Module> def_module) {
 		auto id = expect_id(message);
 		if (!match("_"))
@@ -235,8 +324,11 @@ struct Parser {
 				}
 				continue;
 			}
+			bool is_json = match("@json");
 			bool is_test = match("test");
 			bool is_interface = match("interface");
+			if (is_json && (is_interface || is_test || !match_length("class")))
+				error("@json is applicable only to classes");
 			if (is_interface || match("class")) {
 				auto cls = dom::strict_cast<ast::Class>(get_class_by_name(expect_long_name("class or interface", nullptr)));
 				if (!cls)
@@ -249,6 +341,7 @@ struct Parser {
 				// TODO match attributes if existed
 				cls->is_interface = is_interface;
 				cls->is_test = is_test;
+				cls->is_json = is_json;
 				if (match("(")) {
 					if (!is_first_time_seen)
 						error("Reopened class must reuse existing type parameters");
@@ -272,6 +365,7 @@ struct Parser {
 					expect(")");
 				}
 				expect("{");
+				vector<std::pair<pin<ast::Field>, string>> json_fields;
 				while (!match("}")) {
 					if (match("+")) {
 						auto base_class = parse_class_with_params(expect_long_name("base class", nullptr), false); // disallow class param in root
@@ -298,7 +392,10 @@ struct Parser {
 							cls->fields.push_back(make<ast::Field>());
 							cls->fields.back()->name = member_name;
 							cls->fields.back()->cls = cls;
+							auto initializer_start = cur;
 							cls->fields.back()->initializer = parse_expression();
+							if (is_json)
+								json_fields.push_back({ cls->fields.back(), string(initializer_start, cur) });
 							expect(";");
 						} else {
 							cls->new_methods.push_back(make_method({ member_name, module }, cls, is_interface));
@@ -306,6 +403,8 @@ struct Parser {
 						}
 					}
 				}
+				if (is_json)
+					add_json_methods(cls, json_fields);
 				current_class = nullptr;
 			} else if (match("fn")) {
 				auto fn = make<ast::Function>();
@@ -1310,27 +1409,41 @@ struct Parser {
 				error("oveflow");
 			return result;
 		}
+		if (radix != 10)
+			error("fractional part and exponent are allowed only in decimal numbers");
 		std::feclearexcept(FE_ALL_EXCEPT);
-		double d = double(result);
+		// Collects the literal without `_` separators for the correctly rounded strtod
+		string text = std::to_string(result);
 		if (match_ns('.')) {
-			for (double weight = 0.1; is_num(*cur); weight *= 0.1, cur++, pos++)
-				d += weight * (*cur - '0');
+			text += '.';
+			for (; is_num(*cur) || *cur == '_'; cur++, pos++) {
+				if (*cur != '_')
+					text += *cur;
+			}
 		}
-		if (match_ns("e")) {
-			int sign = match_ns('-') ? -1 : (match_ns('+'), 1);
-			int exp = 0;
-			for (; *cur >= '0' && *cur < '9'; cur++, pos++)
-				exp = exp * 10 + *cur - '0';
-			d *= pow(10, exp * sign);
+		if (*cur == 'e' && (is_num(cur[1]) || ((cur[1] == '-' || cur[1] == '+') && is_num(cur[2])))) {
+			text += 'e';
+			cur++, pos++;
+			if (*cur == '-' || *cur == '+')
+				text += *cur++, pos++;
+			for (; is_num(*cur); cur++, pos++)
+				text += *cur;
 		}
+		double d = std::strtod(text.c_str(), nullptr);
+		if (std::isinf(d))
+			error("double overflow");
+		// Subnormal results also raise FE_UNDERFLOW, only losing all digits is an error
+		bool underflow = std::fetestexcept(FE_UNDERFLOW) != 0;
 		if (match("f")) {
 			float f = (float) d;
-			if (std::fetestexcept(FE_OVERFLOW | FE_UNDERFLOW))
+			if (std::isinf(f))
 				error("float overflow");
+			if (f == 0 && (d != 0 || underflow))
+				error("float underflow");
 			return f;
 		}
-		if (std::fetestexcept(FE_OVERFLOW | FE_UNDERFLOW))
-			error("double overflow");
+		if (d == 0 && underflow)
+			error("double underflow");
 		match_ws();
 		return d;
 	}
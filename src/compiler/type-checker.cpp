@@ -519,6 +519,8 @@ struct Typer : ast::ActionMatcher {
 			node.var = current_underscore_var;
 		}
 		if (node.var->is_const) {
+			if (!node.var->type)  // constants can refer to the ones that are not typed yet
+				node.var->type = find_type(node.var->initializer)->type();
 			node.type_ = node.var->type;
 		} else {
 			node.type_ = ast->convert_maybe_optional(node.var->type, [&](auto tp) {
@@ -892,6 +894,10 @@ struct Typer : ast::ActionMatcher {
 	}
 
 	bool is_compatible(pin<ast::AbstractClass> actual, pin<ast::AbstractClass> expected) {
+		if (auto act_as_param = strict_cast<ast::ClassParam>(actual)) {
+			if (act_as_param->base == expected)  // class parameter is always compatible with its bound
+				return true;
+		}
 		if (actual != expected && !actual->get_implementation()->overloads.count(expected->get_implementation()))
 			return false;
 		auto act_as_inst = strict_cast<ast::ClassInstance>(actual);
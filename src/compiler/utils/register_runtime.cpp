@@ -9,9 +9,17 @@
 #include "../runtime/array/own-array.h"
 #include "../runtime/array/weak-array.h"
 #include "../runtime/array/shared-array.h"
+#include "../runtime/array/typed-array.h"
+#include "../runtime/array/priority-queue.h"
+#include "../runtime/array/deque.h"
 #include "../runtime/map/own-map.h"
 #include "../runtime/map/shared-map.h"
 #include "../runtime/map/weak-map.h"
+#include "../runtime/map/int-map.h"
+#include "../runtime/map/shared-int-map.h"
+#include "../runtime/map/weak-int-map.h"
+#include "../runtime/map/int-set.h"
+#include "../runtime/map/sorted-map.h"
 
 void register_runtime_content(struct ast::Ast& ast) {
 	if (ast.object)
@@ -30,11 +38,14 @@ void register_runtime_content(struct ast::Ast& ast) {
 	obj_equals->used = true;
 	ast.blob = ast.mk_class("Blob", {
 		ast.mk_field("_count", new ast::ConstInt64()),
-		ast.mk_field("_bytes", new ast::ConstInt64())  // ptr
+		ast.mk_field("_bytes", new ast::ConstInt64()),  // ptr
+		ast.mk_field("_bytesAllocated", new ast::ConstInt64())
 	});
 	ast.mk_method(mut::ANY, ast.blob, "capacity", FN(ag_m_sys_Blob_capacity), new ast::ConstInt64, {});
 	ast.mk_method(mut::MUTATING, ast.blob, "insert", FN(&ag_m_sys_Blob_insert), new ast::ConstVoid, { ast.tp_int64(), ast.tp_int64() });
 	ast.mk_method(mut::MUTATING, ast.blob, "delete", FN(ag_m_sys_Blob_delete), new ast::ConstVoid, { ast.tp_int64(), ast.tp_int64() });
+	ast.mk_method(mut::MUTATING, ast.blob, "reserve", FN(ag_m_sys_Blob_reserve), new ast::ConstVoid, { ast.tp_int64() });
+	ast.mk_method(mut::MUTATING, ast.blob, "truncate", FN(ag_m_sys_Blob_truncate), new ast::ConstVoid, { ast.tp_int64() });
 	ast.mk_method(mut::MUTATING, ast.blob, "copy", FN(ag_m_sys_Blob_copy), new ast::ConstBool, { ast.tp_int64(), ast.get_conform_ref(ast.blob), ast.tp_int64(), ast.tp_int64() });
 	ast.mk_method(mut::ANY, ast.blob, "get8At", FN(ag_m_sys_Blob_get8At), new ast::ConstInt32, { ast.tp_int64() });
 	ast.mk_method(mut::MUTATING, ast.blob, "set8At", FN(ag_m_sys_Blob_set8At), new ast::ConstVoid, { ast.tp_int64(), ast.tp_int32() });
@@ -45,7 +56,10 @@ void register_runtime_content(struct ast::Ast& ast) {
 	ast.mk_method(mut::ANY, ast.blob, "get64At", FN(ag_m_sys_Blob_get64At), new ast::ConstInt64, { ast.tp_int64() });
 	ast.mk_method(mut::MUTATING, ast.blob, "set64At", FN(ag_m_sys_Blob_set64At), new ast::ConstVoid, { ast.tp_int64(), ast.tp_int64() });
 	ast.mk_method(mut::MUTATING, ast.blob, "putChAt", FN(ag_m_sys_Blob_putChAt), new ast::ConstInt64, { ast.tp_int64(), ast.tp_int32() });
+	ast.mk_method(mut::MUTATING, ast.blob, "putIntAt", FN(ag_m_sys_Blob_putIntAt), new ast::ConstInt64, { ast.tp_int64(), ast.tp_int64() });
+	ast.mk_method(mut::MUTATING, ast.blob, "putDoubleAt", FN(ag_m_sys_Blob_putDoubleAt), new ast::ConstInt64, { ast.tp_int64(), ast.tp_double() });
 	ast.mk_method(mut::MUTATING, ast.blob, "mkStr", FN(ag_m_sys_Blob_mkStr), new ast::ConstString, { ast.tp_int64(), ast.tp_int64() });
+	ast.mk_method(mut::MUTATING, ast.blob, "mkInternedStr", FN(ag_m_sys_Blob_mkInternedStr), new ast::ConstString, { ast.tp_int64(), ast.tp_int64() });
 
 	ast.str_builder = ast.mk_class("StrBuilder");
 	ast.str_builder->overloads[ast.blob];
@@ -85,7 +99,8 @@ void register_runtime_content(struct ast::Ast& ast) {
 	};
 	ast.own_array = ast.mk_class("Array", {
 		ast.mk_field("_itemsCount", new ast::ConstInt64()),
-		ast.mk_field("_items", new ast::ConstInt64())  // ptr
+		ast.mk_field("_items", new ast::ConstInt64()),  // ptr
+		ast.mk_field("_itemsAllocated", new ast::ConstInt64())
 	});
 	{
 		auto t_cls = add_class_param(ast.own_array);
@@ -96,6 +111,8 @@ void register_runtime_content(struct ast::Ast& ast) {
 		ast.mk_method(mut::ANY, ast.own_array, "capacity", FN(ag_m_sys_Array_capacity), new ast::ConstInt64, {});
 		ast.mk_method(mut::MUTATING, ast.own_array, "insert", FN(&ag_m_sys_Array_insert), new ast::ConstVoid, { ast.tp_int64(), ast.tp_int64() });
 		ast.mk_method(mut::MUTATING, ast.own_array, "delete", FN(ag_m_sys_Array_delete), new ast::ConstVoid, { ast.tp_int64(), ast.tp_int64() });
+		ast.mk_method(mut::MUTATING, ast.own_array, "reserve", FN(ag_m_sys_Array_reserve), new ast::ConstVoid, { ast.tp_int64() });
+		ast.mk_method(mut::MUTATING, ast.own_array, "shrinkToFit", FN(ag_m_sys_Array_shrinkToFit), new ast::ConstVoid, {});
 		ast.mk_method(mut::MUTATING, ast.own_array, "move", FN(ag_m_sys_Array_move), new ast::ConstBool, { ast.tp_int64(), ast.tp_int64(), ast.tp_int64() });
 		ast.mk_method(mut::ANY, ast.own_array, "getAt", FN(ag_m_sys_Array_getAt), opt_ref_to_t_res, { ast.tp_int64() });
 		ast.mk_method(mut::MUTATING, ast.own_array, "setAt", FN(ag_m_sys_Array_setAt), new ast::ConstVoid, { ast.tp_int64(), own_to_t });
@@ -104,48 +121,186 @@ void register_runtime_content(struct ast::Ast& ast) {
 	}
 	ast.weak_array = ast.mk_class("WeakArray", {
 		ast.mk_field("_itemsCount", new ast::ConstInt64()),
-		ast.mk_field("_items", new ast::ConstInt64())  // ptr
+		ast.mk_field("_items", new ast::ConstInt64()),  // ptr
+		ast.mk_field("_itemsAllocated", new ast::ConstInt64())
 	});
 	{
 		auto t_cls = add_class_param(ast.weak_array);
 		ast.mk_method(mut::ANY, ast.weak_array, "capacity", FN(ag_m_sys_WeakArray_capacity), new ast::ConstInt64, {});
 		ast.mk_method(mut::MUTATING, ast.weak_array, "insert", FN(&ag_m_sys_WeakArray_insert), new ast::ConstVoid, { ast.tp_int64(), ast.tp_int64() });
 		ast.mk_method(mut::MUTATING, ast.weak_array, "delete", FN(ag_m_sys_WeakArray_delete), new ast::ConstVoid, { ast.tp_int64(), ast.tp_int64() });
+		ast.mk_method(mut::MUTATING, ast.weak_array, "reserve", FN(ag_m_sys_WeakArray_reserve), new ast::ConstVoid, { ast.tp_int64() });
+		ast.mk_method(mut::MUTATING, ast.weak_array, "shrinkToFit", FN(ag_m_sys_WeakArray_shrinkToFit), new ast::ConstVoid, {});
 		ast.mk_method(mut::MUTATING, ast.weak_array, "move", FN(ag_m_sys_WeakArray_move), new ast::ConstBool, { ast.tp_int64(), ast.tp_int64(), ast.tp_int64() });
 		ast.mk_method(mut::ANY, ast.weak_array, "getAt", FN(ag_m_sys_WeakArray_getAt), make_ptr_result(new ast::MkWeakOp, t_cls), { ast.tp_int64() });
 		ast.mk_method(mut::MUTATING, ast.weak_array, "setAt", FN(ag_m_sys_WeakArray_setAt), new ast::ConstVoid, { ast.tp_int64(), ast.get_weak(t_cls) });
 	}
+	ltm::pin<ast::Class> shared_array_cls;
 	{
-		auto shared_array_cls = ast.mk_class("SharedArray", {
+		shared_array_cls = ast.mk_class("SharedArray", {
 			ast.mk_field("_itemsCount", new ast::ConstInt64()),
-			ast.mk_field("_items", new ast::ConstInt64())  // ptr
+			ast.mk_field("_items", new ast::ConstInt64()),  // ptr
+			ast.mk_field("_itemsAllocated", new ast::ConstInt64())
 		});
 		auto t_cls = add_class_param(shared_array_cls);
 		ast.mk_method(mut::ANY, shared_array_cls, "capacity", FN(ag_m_sys_SharedArray_capacity), new ast::ConstInt64, {});
 		ast.mk_method(mut::MUTATING, shared_array_cls, "insert", FN(&ag_m_sys_SharedArray_insert), new ast::ConstVoid, { ast.tp_int64(), ast.tp_int64() });
 		ast.mk_method(mut::MUTATING, shared_array_cls, "delete", FN(ag_m_sys_SharedArray_delete), new ast::ConstVoid, { ast.tp_int64(), ast.tp_int64() });
+		ast.mk_method(mut::MUTATING, shared_array_cls, "reserve", FN(ag_m_sys_SharedArray_reserve), new ast::ConstVoid, { ast.tp_int64() });
+		ast.mk_method(mut::MUTATING, shared_array_cls, "shrinkToFit", FN(ag_m_sys_SharedArray_shrinkToFit), new ast::ConstVoid, {});
 		ast.mk_method(mut::MUTATING, shared_array_cls, "move", FN(ag_m_sys_SharedArray_move), new ast::ConstBool, { ast.tp_int64(), ast.tp_int64(), ast.tp_int64() });
 		ast.mk_method(mut::ANY, shared_array_cls, "getAt", FN(ag_m_sys_SharedArray_getAt), make_opt_result(make_ptr_result(new ast::FreezeOp, t_cls)), { ast.tp_int64() });
 		ast.mk_method(mut::MUTATING, shared_array_cls, "setAt", FN(ag_m_sys_SharedArray_setAt), new ast::ConstVoid, { ast.tp_int64(), ast.get_shared(t_cls) });
 	}
+	// Unboxed numeric arrays. Generator inlines their getAt/setAt, so field layout must match AgTypedArray.
+#define AG_TYPED_ARRAY(NAME, CONST_ITEM, TP_ITEM) {                                                                       \
+		auto cls = ast.mk_class(#NAME, {                                                                                   \
+			ast.mk_field("_itemsCount", new ast::ConstInt64()),                                                            \
+			ast.mk_field("_items", new ast::ConstInt64()),  /* ptr */                                                      \
+			ast.mk_field("_itemsAllocated", new ast::ConstInt64()) });                                                     \
+		ast.mk_method(mut::ANY, cls, "capacity", FN(ag_m_sys_##NAME##_capacity), new ast::ConstInt64, {});                 \
+		ast.mk_method(mut::MUTATING, cls, "insert", FN(ag_m_sys_##NAME##_insert), new ast::ConstVoid, { ast.tp_int64(), ast.tp_int64() }); \
+		ast.mk_method(mut::MUTATING, cls, "delete", FN(ag_m_sys_##NAME##_delete), new ast::ConstVoid, { ast.tp_int64(), ast.tp_int64() }); \
+		ast.mk_method(mut::MUTATING, cls, "reserve", FN(ag_m_sys_##NAME##_reserve), new ast::ConstVoid, { ast.tp_int64() }); \
+		ast.mk_method(mut::MUTATING, cls, "shrinkToFit", FN(ag_m_sys_##NAME##_shrinkToFit), new ast::ConstVoid, {});    \
+		ast.mk_method(mut::ANY, cls, "getAt", FN(ag_m_sys_##NAME##_getAt), new ast::CONST_ITEM, { ast.tp_int64() });      \
+		ast.mk_method(mut::MUTATING, cls, "setAt", FN(ag_m_sys_##NAME##_setAt), new ast::ConstVoid, { ast.tp_int64(), ast.TP_ITEM() }); \
+		ast.mk_method(mut::MUTATING, cls, "fill", FN(ag_m_sys_##NAME##_fill), new ast::ConstBool, { ast.tp_int64(), ast.tp_int64(), ast.TP_ITEM() }); \
+		ast.mk_method(mut::MUTATING, cls, "copy", FN(ag_m_sys_##NAME##_copy), new ast::ConstBool, { ast.tp_int64(), ast.get_conform_ref(cls), ast.tp_int64(), ast.tp_int64() }); \
+		ast.mk_method(mut::MUTATING, cls, "sort", FN(ag_m_sys_##NAME##_sort), new ast::ConstVoid, {});                   \
+		ast.mk_method(mut::MUTATING, cls, "nthElement", FN(ag_m_sys_##NAME##_nthElement), new ast::ConstVoid, { ast.tp_int64() }); \
+		ast.mk_method(mut::ANY, cls, "lowerBound", FN(ag_m_sys_##NAME##_lowerBound), new ast::ConstInt64, { ast.TP_ITEM() }); \
+		ast.mk_method(mut::ANY, cls, "upperBound", FN(ag_m_sys_##NAME##_upperBound), new ast::ConstInt64, { ast.TP_ITEM() }); \
+	}
+	AG_TYPED_ARRAY(Int32Array, ConstInt32, tp_int32)
+	AG_TYPED_ARRAY(Int64Array, ConstInt64, tp_int64)
+	AG_TYPED_ARRAY(FloatArray, ConstFloat, tp_float)
+	AG_TYPED_ARRAY(DoubleArray, ConstDouble, tp_double)
+#undef AG_TYPED_ARRAY
+	// 4-ary min-heaps of owned items, `push`/`append` return handles used in `decreaseKey`, `remove` and `contains`
+#define AG_PRIORITY_QUEUE(NAME, CONST_KEY, TP_KEY) {                                                                    \
+		auto cls = ast.mk_class(#NAME, {                                                                                   \
+			ast.mk_field("_entries", new ast::ConstInt64()),                                                               \
+			ast.mk_field("_slots", new ast::ConstInt64()),                                                                 \
+			ast.mk_field("_size", new ast::ConstInt64()),                                                                  \
+			ast.mk_field("_allocated", new ast::ConstInt64()),                                                             \
+			ast.mk_field("_slotsCount", new ast::ConstInt64()),                                                            \
+			ast.mk_field("_freeSlot", new ast::ConstInt64()),                                                              \
+			ast.mk_field("_heapSize", new ast::ConstInt64()) });                                                           \
+		auto t_cls = add_class_param(cls);                                                                                 \
+		auto opt_ref_to_t_res = make_opt_result(make_ptr_result(new ast::RefOp, t_cls));                                   \
+		ast.mk_method(mut::ANY, cls, "size", FN(ag_m_sys_##NAME##_size), new ast::ConstInt64, {});                         \
+		ast.mk_method(mut::MUTATING, cls, "clear", FN(ag_m_sys_##NAME##_clear), new ast::ConstVoid, {});                   \
+		ast.mk_method(mut::MUTATING, cls, "reserve", FN(ag_m_sys_##NAME##_reserve), new ast::ConstVoid, { ast.tp_int64() }); \
+		ast.mk_method(mut::MUTATING, cls, "push", FN(ag_m_sys_##NAME##_push), new ast::ConstInt64, { ast.TP_KEY(), ast.get_own(t_cls) }); \
+		ast.mk_method(mut::MUTATING, cls, "append", FN(ag_m_sys_##NAME##_append), new ast::ConstInt64, { ast.TP_KEY(), ast.get_own(t_cls) }); \
+		ast.mk_method(mut::MUTATING, cls, "heapify", FN(ag_m_sys_##NAME##_heapify), new ast::ConstVoid, {});               \
+		ast.mk_method(mut::MUTATING, cls, "peek", FN(ag_m_sys_##NAME##_peek), opt_ref_to_t_res, {});                       \
+		ast.mk_method(mut::MUTATING, cls, "peekPriority", FN(ag_m_sys_##NAME##_peekPriority), new ast::CONST_KEY, {});     \
+		ast.mk_method(mut::MUTATING, cls, "pop", FN(ag_m_sys_##NAME##_pop), opt_ref_to_t_res, {});                         \
+		ast.mk_method(mut::ANY, cls, "contains", FN(ag_m_sys_##NAME##_contains), new ast::ConstBool, { ast.tp_int64() });  \
+		ast.mk_method(mut::MUTATING, cls, "decreaseKey", FN(ag_m_sys_##NAME##_decreaseKey), new ast::ConstBool, { ast.tp_int64(), ast.TP_KEY() }); \
+		ast.mk_method(mut::MUTATING, cls, "remove", FN(ag_m_sys_##NAME##_remove), opt_ref_to_t_res, { ast.tp_int64() });   \
+	}
+	AG_PRIORITY_QUEUE(PriorityQueue, ConstInt64, tp_int64)
+	AG_PRIORITY_QUEUE(DoublePriorityQueue, ConstDouble, tp_double)
+#undef AG_PRIORITY_QUEUE
+	// Ring buffers with O(1) push and pop at both ends, pops return detached items
+#define AG_DEQUE(NAME, MK_ITEM, ITEM_RES) {                                                                             \
+		auto cls = ast.mk_class(#NAME, {                                                                                   \
+			ast.mk_field("_items", new ast::ConstInt64()),  /* ptr */                                                      \
+			ast.mk_field("_capacity", new ast::ConstInt64()),                                                              \
+			ast.mk_field("_start", new ast::ConstInt64()),                                                                 \
+			ast.mk_field("_count", new ast::ConstInt64()) });                                                              \
+		auto t_cls = add_class_param(cls);                                                                                 \
+		auto item_t = ast.MK_ITEM(t_cls);                                                                                  \
+		auto item_res = ITEM_RES;                                                                                          \
+		ast.mk_method(mut::ANY, cls, "size", FN(ag_m_sys_##NAME##_size), new ast::ConstInt64, {});                         \
+		ast.mk_method(mut::MUTATING, cls, "clear", FN(ag_m_sys_##NAME##_clear), new ast::ConstVoid, {});                   \
+		ast.mk_method(mut::MUTATING, cls, "reserve", FN(ag_m_sys_##NAME##_reserve), new ast::ConstVoid, { ast.tp_int64() }); \
+		ast.mk_method(mut::MUTATING, cls, "pushBack", FN(ag_m_sys_##NAME##_pushBack), new ast::ConstVoid, { item_t });     \
+		ast.mk_method(mut::MUTATING, cls, "pushFront", FN(ag_m_sys_##NAME##_pushFront), new ast::ConstVoid, { item_t });   \
+		ast.mk_method(mut::MUTATING, cls, "popBack", FN(ag_m_sys_##NAME##_popBack), item_res, {});                         \
+		ast.mk_method(mut::MUTATING, cls, "popFront", FN(ag_m_sys_##NAME##_popFront), item_res, {});                       \
+		ast.mk_method(mut::ANY, cls, "getAt", FN(ag_m_sys_##NAME##_getAt), item_res, { ast.tp_int64() });                  \
+		ast.mk_method(mut::MUTATING, cls, "setAt", FN(ag_m_sys_##NAME##_setAt), new ast::ConstVoid, { ast.tp_int64(), item_t }); \
+	}
+	AG_DEQUE(Deque, get_own, make_opt_result(make_ptr_result(new ast::RefOp, t_cls)))
+	AG_DEQUE(SharedDeque, get_shared, make_opt_result(make_ptr_result(new ast::FreezeOp, t_cls)))
+	AG_DEQUE(WeakDeque, get_weak, make_ptr_result(new ast::MkWeakOp, t_cls))
+#undef AG_DEQUE
 	ast.string_cls = ast.mk_class("String", {});
 	ast.string_cls->used = true;
 	ast.mk_overload(ast.string_cls, FN(ag_m_sys_String_getHash), obj_get_hash);
 	ast.mk_overload(ast.string_cls, FN(ag_m_sys_String_equals), obj_equals);
+	// Sorting of object arrays, comparators and key extractors are delegates called for not null items
+#define AG_ARRAY_SORT_METHODS(NAME, CLS, ITEM_TYPE) {                                                                       \
+		auto tp_bool = ast.tp_optional(ast.tp_void());                                                                     \
+		auto less = ast.tp_delegate({ ITEM_TYPE, ITEM_TYPE, tp_bool });                                                    \
+		auto predicate = ast.tp_delegate({ ITEM_TYPE, tp_bool });                                                          \
+		ast.mk_method(mut::MUTATING, CLS, "sort", FN(ag_m_sys_##NAME##_sort), new ast::ConstVoid, { less });               \
+		ast.mk_method(mut::MUTATING, CLS, "stableSort", FN(ag_m_sys_##NAME##_stableSort), new ast::ConstVoid, { less });   \
+		ast.mk_method(mut::MUTATING, CLS, "nthElement", FN(ag_m_sys_##NAME##_nthElement), new ast::ConstVoid, { ast.tp_int64(), less }); \
+		ast.mk_method(mut::MUTATING, CLS, "partition", FN(ag_m_sys_##NAME##_partition), new ast::ConstInt64, { predicate }); \
+		ast.mk_method(mut::ANY, CLS, "lowerBound", FN(ag_m_sys_##NAME##_lowerBound), new ast::ConstInt64, { predicate });  \
+		ast.mk_method(mut::MUTATING, CLS, "sortByInt", FN(ag_m_sys_##NAME##_sortByInt), new ast::ConstVoid, {              \
+			ast.tp_delegate({ ITEM_TYPE, ast.tp_int64() }) });                                                             \
+		ast.mk_method(mut::MUTATING, CLS, "sortByStr", FN(ag_m_sys_##NAME##_sortByStr), new ast::ConstVoid, {              \
+			ast.tp_delegate({ ITEM_TYPE, ast.get_shared(ast.string_cls) }) });                                             \
+	}
+	AG_ARRAY_SORT_METHODS(Array, ast.own_array, ast.get_ref(ast.own_array->params[0]))
+	AG_ARRAY_SORT_METHODS(SharedArray, shared_array_cls, ast.get_shared(shared_array_cls->params[0]))
+#undef AG_ARRAY_SORT_METHODS
+	auto slice_cls = ast.mk_class("StringSlice", {
+			ast.mk_field("_buffer", new ast::ConstString),
+			ast.mk_field("_start", new ast::ConstInt64),
+			ast.mk_field("_end", new ast::ConstInt64) });
 	{
 		auto cursor_cls = ast.mk_class("Cursor", {
 				ast.mk_field("_cursor", new ast::ConstInt64),
-				ast.mk_field("_buffer", new ast::ConstString) });
+				ast.mk_field("_buffer", new ast::ConstString),
+				ast.mk_field("_end", new ast::ConstInt64) });
 		ast.mk_method(mut::MUTATING, cursor_cls, "getCh", FN(ag_m_sys_Cursor_getCh), new ast::ConstInt32, {});
 		ast.mk_method(mut::ANY, cursor_cls, "peekCh", FN(ag_m_sys_Cursor_peekCh), new ast::ConstInt32, {});
 		ast.mk_method(mut::ANY, cursor_cls, "offset", FN(ag_m_sys_Cursor_offset), new ast::ConstInt64, {});
+		ast.mk_method(mut::MUTATING, cursor_cls, "parseDouble", FN(ag_m_sys_Cursor_parseDouble), new ast::ConstDouble, { ast.tp_int64() });
+		ast.mk_method(mut::MUTATING, cursor_cls, "getSliceTill", FN(ag_m_sys_Cursor_getSliceTill), new ast::ConstBool, { ast.tp_int32(), ast.get_conform_ref(slice_cls) });
+		ast.mk_method(mut::MUTATING, cursor_cls, "seekCh", FN(ag_m_sys_Cursor_seekCh), new ast::ConstBool, { ast.tp_int32() });
+		ast.mk_method(mut::MUTATING, cursor_cls, "seekStr", FN(ag_m_sys_Cursor_seekStr), new ast::ConstBool, { ast.get_shared(ast.string_cls) });
+		ast.mk_method(mut::MUTATING, cursor_cls, "skipSpaces", FN(ag_m_sys_Cursor_skipSpaces), new ast::ConstVoid, {});
+		ast.mk_method(mut::ANY, cursor_cls, "runeCount", FN(ag_m_sys_Cursor_runeCount), new ast::ConstInt64, {});
+		ast.mk_method(mut::ANY, cursor_cls, "isValidUtf8", FN(ag_m_sys_Cursor_isValidUtf8), new ast::ConstBool, {});
+		ast.mk_method(mut::MUTATING, cursor_cls, "skipJsonStr", FN(ag_m_sys_Cursor_skipJsonStr), new ast::ConstInt64, {});
+		ast.mk_method(mut::MUTATING, cursor_cls, "skipJsonNested", FN(ag_m_sys_Cursor_skipJsonNested), new ast::ConstInt64, { ast.tp_int32() });
+		ast.mk_method(mut::MUTATING, ast.blob, "putJsonStrAt", FN(ag_m_sys_Blob_putJsonStrAt), new ast::ConstInt64, { ast.tp_int64(), ast.get_conform_ref(cursor_cls), ast.tp_int64() });
 		make_factory(ast.mk_method(mut::MUTATING, cursor_cls, "set", FN(ag_m_sys_Cursor_set), nullptr, { ast.get_shared(ast.string_cls) }));
+		make_factory(ast.mk_method(mut::MUTATING, cursor_cls, "setSlice", FN(ag_m_sys_Cursor_setSlice), nullptr, { ast.get_conform_ref(slice_cls) }));
+		// Slices take offsets in the cursor's string, as returned by `Cursor.offset`
+		ast.mk_overload(slice_cls, FN(ag_m_sys_StringSlice_getHash), obj_get_hash);
+		ast.mk_overload(slice_cls, FN(ag_m_sys_StringSlice_equals), obj_equals);
+		make_factory(ast.mk_method(mut::MUTATING, slice_cls, "set", FN(ag_m_sys_StringSlice_set), nullptr, { ast.get_shared(ast.string_cls), ast.tp_int64(), ast.tp_int64() }));
+		make_factory(ast.mk_method(mut::MUTATING, slice_cls, "fromCursor", FN(ag_m_sys_StringSlice_fromCursor), nullptr, { ast.get_conform_ref(cursor_cls), ast.tp_int64(), ast.tp_int64() }));
+		ast.mk_method(mut::ANY, slice_cls, "size", FN(ag_m_sys_StringSlice_size), new ast::ConstInt64, {});
+		ast.mk_method(mut::ANY, slice_cls, "equalsStr", FN(ag_m_sys_StringSlice_equalsStr), new ast::ConstBool, { ast.get_shared(ast.string_cls) });
+		ast.mk_method(mut::ANY, slice_cls, "toStr", FN(ag_m_sys_StringSlice_toStr), new ast::ConstString, {});
 	}
+	// Blob bulk appends, registered here as they take strings, slices and arrays of strings
+	ast.mk_method(mut::MUTATING, ast.blob, "putStrAt", FN(ag_m_sys_Blob_putStrAt), new ast::ConstInt64, { ast.tp_int64(), ast.get_shared(ast.string_cls) });
+	ast.mk_method(mut::MUTATING, ast.blob, "putSubstrAt", FN(ag_m_sys_Blob_putSubstrAt), new ast::ConstInt64, { ast.tp_int64(), ast.get_shared(ast.string_cls), ast.tp_int64(), ast.tp_int64() });
+	ast.mk_method(mut::MUTATING, ast.blob, "putSliceAt", FN(ag_m_sys_Blob_putSliceAt), new ast::ConstInt64, { ast.tp_int64(), ast.get_conform_ref(slice_cls) });
+	ast.mk_method(mut::MUTATING, ast.blob, "putBlobAt", FN(ag_m_sys_Blob_putBlobAt), new ast::ConstInt64, { ast.tp_int64(), ast.get_conform_ref(ast.blob), ast.tp_int64(), ast.tp_int64() });
+	ast.mk_method(mut::MUTATING, ast.blob, "putRepeatAt", FN(ag_m_sys_Blob_putRepeatAt), new ast::ConstInt64, { ast.tp_int64(), ast.tp_int32(), ast.tp_int64() });
+	ast.mk_method(mut::MUTATING, ast.blob, "putJsonQuotedAt", FN(ag_m_sys_Blob_putJsonQuotedAt), new ast::ConstInt64, { ast.tp_int64(), ast.get_shared(ast.string_cls) });
+	ast.mk_method(mut::MUTATING, ast.blob, "putJoinedAt", FN(ag_m_sys_Blob_putJoinedAt), new ast::ConstInt64, {
+		ast.tp_int64(),
+		ast.get_conform_ref(ast.get_class_instance({ shared_array_cls, ast.string_cls })),
+		ast.get_shared(ast.string_cls) });
 	{
 		auto map_cls = ast.mk_class("Map", {
 			ast.mk_field("_buckets", new ast::ConstInt64),
 			ast.mk_field("_capacity", new ast::ConstInt64),
-			ast.mk_field("_size", new ast::ConstInt64) });
+			ast.mk_field("_size", new ast::ConstInt64),
+			ast.mk_field("_growthLeft", new ast::ConstInt64) });
 		auto key_cls = add_class_param(map_cls, "K");
 		auto val_cls = add_class_param(map_cls, "V");
 		auto ref_to_val_res = make_ptr_result(new ast::RefOp, val_cls);
@@ -160,12 +315,16 @@ void register_runtime_content(struct ast::Ast& ast) {
 		ast.mk_method(mut::ANY, map_cls, "setAt", FN(ag_m_sys_Map_setAt), opt_ref_to_val_res, { ast.get_shared(key_cls), ast.get_own(val_cls) });
 		ast.mk_method(mut::ANY, map_cls, "keyAt", FN(ag_m_sys_Map_keyAt), opt_shared_to_key_res, { ast.tp_int64() });
 		ast.mk_method(mut::ANY, map_cls, "valAt", FN(ag_m_sys_Map_valAt), opt_ref_to_val_res, { ast.tp_int64() });
+		ast.mk_method(mut::MUTATING, map_cls, "reserve", FN(ag_m_sys_Map_reserve), new ast::ConstVoid, { ast.tp_int64() });
+		ast.mk_method(mut::MUTATING, map_cls, "shrinkToFit", FN(ag_m_sys_Map_shrinkToFit), new ast::ConstVoid, {});
+		ast.mk_method(mut::MUTATING, map_cls, "removeAt", FN(ag_m_sys_Map_removeAt), new ast::ConstVoid, { ast.tp_int64() });
 	}
 	{
 		auto map_cls = ast.mk_class("SharedMap", {
 			ast.mk_field("_buckets", new ast::ConstInt64),
 			ast.mk_field("_capacity", new ast::ConstInt64),
-			ast.mk_field("_size", new ast::ConstInt64) });
+			ast.mk_field("_size", new ast::ConstInt64),
+			ast.mk_field("_growthLeft", new ast::ConstInt64) });
 		auto key_cls = add_class_param(map_cls, "K");
 		auto val_cls = add_class_param(map_cls, "V");
 		auto shared_to_val_res = make_ptr_result(new ast::FreezeOp, val_cls);
@@ -180,12 +339,18 @@ void register_runtime_content(struct ast::Ast& ast) {
 		ast.mk_method(mut::ANY, map_cls, "setAt", FN(ag_m_sys_SharedMap_setAt), opt_shared_to_val_res, { ast.get_shared(key_cls), ast.get_shared(val_cls) });
 		ast.mk_method(mut::ANY, map_cls, "keyAt", FN(ag_m_sys_SharedMap_keyAt), opt_shared_to_key_res, { ast.tp_int64() });
 		ast.mk_method(mut::ANY, map_cls, "valAt", FN(ag_m_sys_SharedMap_valAt), opt_shared_to_val_res, { ast.tp_int64() });
+		ast.mk_method(mut::MUTATING, map_cls, "reserve", FN(ag_m_sys_SharedMap_reserve), new ast::ConstVoid, { ast.tp_int64() });
+		ast.mk_method(mut::MUTATING, map_cls, "shrinkToFit", FN(ag_m_sys_SharedMap_shrinkToFit), new ast::ConstVoid, {});
+		ast.mk_method(mut::MUTATING, map_cls, "removeAt", FN(ag_m_sys_SharedMap_removeAt), new ast::ConstVoid, { ast.tp_int64() });
+		ast.mk_method(mut::MUTATING, map_cls, "setAll", FN(ag_m_sys_SharedMap_setAll), new ast::ConstVoid, {
+			ast.get_conform_ref(ast.get_class_instance({ map_cls, key_cls, val_cls })) });
 	}
 	{
 		auto map_cls = ast.mk_class("WeakMap", {
 			ast.mk_field("_buckets", new ast::ConstInt64),
 			ast.mk_field("_capacity", new ast::ConstInt64),
-			ast.mk_field("_size", new ast::ConstInt64) });
+			ast.mk_field("_size", new ast::ConstInt64),
+			ast.mk_field("_growthLeft", new ast::ConstInt64) });
 		auto key_cls = add_class_param(map_cls, "K");
 		auto val_cls = add_class_param(map_cls, "V");
 		auto weak_to_val_res = make_ptr_result(new ast::MkWeakOp, val_cls);
@@ -199,10 +364,150 @@ void register_runtime_content(struct ast::Ast& ast) {
 		ast.mk_method(mut::ANY, map_cls, "setAt", FN(ag_m_sys_WeakMap_setAt), weak_to_val_res, { ast.get_shared(key_cls), ast.get_weak(val_cls) });
 		ast.mk_method(mut::ANY, map_cls, "keyAt", FN(ag_m_sys_WeakMap_keyAt), opt_shared_to_key_res, { ast.tp_int64() });
 		ast.mk_method(mut::ANY, map_cls, "valAt", FN(ag_m_sys_WeakMap_valAt), weak_to_val_res, { ast.tp_int64() });
+		ast.mk_method(mut::MUTATING, map_cls, "reserve", FN(ag_m_sys_WeakMap_reserve), new ast::ConstVoid, { ast.tp_int64() });
+		ast.mk_method(mut::MUTATING, map_cls, "shrinkToFit", FN(ag_m_sys_WeakMap_shrinkToFit), new ast::ConstVoid, {});
+		ast.mk_method(mut::MUTATING, map_cls, "removeAt", FN(ag_m_sys_WeakMap_removeAt), new ast::ConstVoid, { ast.tp_int64() });
+		ast.mk_method(mut::MUTATING, map_cls, "setAll", FN(ag_m_sys_WeakMap_setAll), new ast::ConstVoid, {
+			ast.get_conform_ref(ast.get_class_instance({ map_cls, key_cls, val_cls })) });
+	}
+	auto mk_int_map_class = [&](const char* name) {
+		return ast.mk_class(name, {
+			ast.mk_field("_buckets", new ast::ConstInt64),
+			ast.mk_field("_capacity", new ast::ConstInt64),
+			ast.mk_field("_size", new ast::ConstInt64),
+			ast.mk_field("_growthLeft", new ast::ConstInt64) });
+	};
+	{
+		auto map_cls = mk_int_map_class("IntMap");
+		auto val_cls = add_class_param(map_cls, "V");
+		auto opt_ref_to_val_res = make_opt_result(make_ptr_result(new ast::RefOp, val_cls));
+		ast.mk_method(mut::ANY, map_cls, "size", FN(ag_m_sys_IntMap_size), new ast::ConstInt64, {});
+		ast.mk_method(mut::ANY, map_cls, "capacity", FN(ag_m_sys_IntMap_capacity), new ast::ConstInt64, {});
+		ast.mk_method(mut::MUTATING, map_cls, "clear", FN(ag_m_sys_IntMap_clear), new ast::ConstVoid, {});
+		ast.mk_method(mut::MUTATING, map_cls, "delete", FN(ag_m_sys_IntMap_delete), opt_ref_to_val_res, { ast.tp_int64() });
+		ast.mk_method(mut::ANY, map_cls, "getAt", FN(ag_m_sys_IntMap_getAt), opt_ref_to_val_res, { ast.tp_int64() });
+		ast.mk_method(mut::MUTATING, map_cls, "setAt", FN(ag_m_sys_IntMap_setAt), opt_ref_to_val_res, { ast.tp_int64(), ast.get_own(val_cls) });
+		ast.mk_method(mut::ANY, map_cls, "usedAt", FN(ag_m_sys_IntMap_usedAt), new ast::ConstBool, { ast.tp_int64() });
+		ast.mk_method(mut::ANY, map_cls, "keyAt", FN(ag_m_sys_IntMap_keyAt), new ast::ConstInt64, { ast.tp_int64() });
+		ast.mk_method(mut::ANY, map_cls, "valAt", FN(ag_m_sys_IntMap_valAt), opt_ref_to_val_res, { ast.tp_int64() });
+		ast.mk_method(mut::MUTATING, map_cls, "reserve", FN(ag_m_sys_IntMap_reserve), new ast::ConstVoid, { ast.tp_int64() });
+		ast.mk_method(mut::MUTATING, map_cls, "shrinkToFit", FN(ag_m_sys_IntMap_shrinkToFit), new ast::ConstVoid, {});
+		ast.mk_method(mut::MUTATING, map_cls, "removeAt", FN(ag_m_sys_IntMap_removeAt), new ast::ConstVoid, { ast.tp_int64() });
+	}
+	{
+		auto map_cls = mk_int_map_class("SharedIntMap");
+		auto val_cls = add_class_param(map_cls, "V");
+		auto opt_shared_to_val_res = make_opt_result(make_ptr_result(new ast::FreezeOp, val_cls));
+		ast.mk_method(mut::ANY, map_cls, "size", FN(ag_m_sys_SharedIntMap_size), new ast::ConstInt64, {});
+		ast.mk_method(mut::ANY, map_cls, "capacity", FN(ag_m_sys_SharedIntMap_capacity), new ast::ConstInt64, {});
+		ast.mk_method(mut::MUTATING, map_cls, "clear", FN(ag_m_sys_SharedIntMap_clear), new ast::ConstVoid, {});
+		ast.mk_method(mut::MUTATING, map_cls, "delete", FN(ag_m_sys_SharedIntMap_delete), opt_shared_to_val_res, { ast.tp_int64() });
+		ast.mk_method(mut::ANY, map_cls, "getAt", FN(ag_m_sys_SharedIntMap_getAt), opt_shared_to_val_res, { ast.tp_int64() });
+		ast.mk_method(mut::MUTATING, map_cls, "setAt", FN(ag_m_sys_SharedIntMap_setAt), opt_shared_to_val_res, { ast.tp_int64(), ast.get_shared(val_cls) });
+		ast.mk_method(mut::ANY, map_cls, "usedAt", FN(ag_m_sys_SharedIntMap_usedAt), new ast::ConstBool, { ast.tp_int64() });
+		ast.mk_method(mut::ANY, map_cls, "keyAt", FN(ag_m_sys_SharedIntMap_keyAt), new ast::ConstInt64, { ast.tp_int64() });
+		ast.mk_method(mut::ANY, map_cls, "valAt", FN(ag_m_sys_SharedIntMap_valAt), opt_shared_to_val_res, { ast.tp_int64() });
+		ast.mk_method(mut::MUTATING, map_cls, "reserve", FN(ag_m_sys_SharedIntMap_reserve), new ast::ConstVoid, { ast.tp_int64() });
+		ast.mk_method(mut::MUTATING, map_cls, "shrinkToFit", FN(ag_m_sys_SharedIntMap_shrinkToFit), new ast::ConstVoid, {});
+		ast.mk_method(mut::MUTATING, map_cls, "removeAt", FN(ag_m_sys_SharedIntMap_removeAt), new ast::ConstVoid, { ast.tp_int64() });
+	}
+	{
+		auto map_cls = mk_int_map_class("WeakIntMap");
+		auto val_cls = add_class_param(map_cls, "V");
+		auto weak_to_val_res = make_ptr_result(new ast::MkWeakOp, val_cls);
+		ast.mk_method(mut::ANY, map_cls, "size", FN(ag_m_sys_WeakIntMap_size), new ast::ConstInt64, {});
+		ast.mk_method(mut::ANY, map_cls, "capacity", FN(ag_m_sys_WeakIntMap_capacity), new ast::ConstInt64, {});
+		ast.mk_method(mut::MUTATING, map_cls, "clear", FN(ag_m_sys_WeakIntMap_clear), new ast::ConstVoid, {});
+		ast.mk_method(mut::MUTATING, map_cls, "delete", FN(ag_m_sys_WeakIntMap_delete), weak_to_val_res, { ast.tp_int64() });
+		ast.mk_method(mut::ANY, map_cls, "getAt", FN(ag_m_sys_WeakIntMap_getAt), weak_to_val_res, { ast.tp_int64() });
+		ast.mk_method(mut::MUTATING, map_cls, "setAt", FN(ag_m_sys_WeakIntMap_setAt), weak_to_val_res, { ast.tp_int64(), ast.get_weak(val_cls) });
+		ast.mk_method(mut::ANY, map_cls, "usedAt", FN(ag_m_sys_WeakIntMap_usedAt), new ast::ConstBool, { ast.tp_int64() });
+		ast.mk_method(mut::ANY, map_cls, "keyAt", FN(ag_m_sys_WeakIntMap_keyAt), new ast::ConstInt64, { ast.tp_int64() });
+		ast.mk_method(mut::ANY, map_cls, "valAt", FN(ag_m_sys_WeakIntMap_valAt), weak_to_val_res, { ast.tp_int64() });
+		ast.mk_method(mut::MUTATING, map_cls, "reserve", FN(ag_m_sys_WeakIntMap_reserve), new ast::ConstVoid, { ast.tp_int64() });
+		ast.mk_method(mut::MUTATING, map_cls, "shrinkToFit", FN(ag_m_sys_WeakIntMap_shrinkToFit), new ast::ConstVoid, {});
+		ast.mk_method(mut::MUTATING, map_cls, "removeAt", FN(ag_m_sys_WeakIntMap_removeAt), new ast::ConstVoid, { ast.tp_int64() });
+	}
+	{
+		auto set_cls = mk_int_map_class("IntSet");
+		ast.mk_method(mut::ANY, set_cls, "size", FN(ag_m_sys_IntSet_size), new ast::ConstInt64, {});
+		ast.mk_method(mut::ANY, set_cls, "capacity", FN(ag_m_sys_IntSet_capacity), new ast::ConstInt64, {});
+		ast.mk_method(mut::MUTATING, set_cls, "clear", FN(ag_m_sys_IntSet_clear), new ast::ConstVoid, {});
+		ast.mk_method(mut::ANY, set_cls, "contains", FN(ag_m_sys_IntSet_contains), new ast::ConstBool, { ast.tp_int64() });
+		ast.mk_method(mut::MUTATING, set_cls, "add", FN(ag_m_sys_IntSet_add), new ast::ConstBool, { ast.tp_int64() });
+		ast.mk_method(mut::MUTATING, set_cls, "delete", FN(ag_m_sys_IntSet_delete), new ast::ConstBool, { ast.tp_int64() });
+		ast.mk_method(mut::ANY, set_cls, "usedAt", FN(ag_m_sys_IntSet_usedAt), new ast::ConstBool, { ast.tp_int64() });
+		ast.mk_method(mut::ANY, set_cls, "keyAt", FN(ag_m_sys_IntSet_keyAt), new ast::ConstInt64, { ast.tp_int64() });
+		ast.mk_method(mut::MUTATING, set_cls, "reserve", FN(ag_m_sys_IntSet_reserve), new ast::ConstVoid, { ast.tp_int64() });
+		ast.mk_method(mut::MUTATING, set_cls, "shrinkToFit", FN(ag_m_sys_IntSet_shrinkToFit), new ast::ConstVoid, {});
+		ast.mk_method(mut::MUTATING, set_cls, "removeAt", FN(ag_m_sys_IntSet_removeAt), new ast::ConstVoid, { ast.tp_int64() });
+	}
+	auto mk_sorted_map_class = [&](const char* name) {
+		return ast.mk_class(name, {
+			ast.mk_field("_root", new ast::ConstInt64),
+			ast.mk_field("_first", new ast::ConstInt64),
+			ast.mk_field("_size", new ast::ConstInt64),
+			ast.mk_field("_cursorLeaf", new ast::ConstInt64),
+			ast.mk_field("_cursorIndex", new ast::ConstInt64),
+			ast.mk_field("_cursorRank", new ast::ConstInt64) });
+	};
+	auto str_key = ast.get_shared(ast.string_cls);
+#define AG_SORTED_MAP(NAME, KEY, KEY_RES, VAL_RES, VAL)                                                            \
+	{                                                                                                              \
+		auto map_cls = mk_sorted_map_class(#NAME);                                                                 \
+		auto val_cls = add_class_param(map_cls, "V");                                                              \
+		auto val_res = VAL_RES;                                                                                    \
+		ast.mk_method(mut::ANY, map_cls, "size", FN(ag_m_sys_##NAME##_size), new ast::ConstInt64, {});             \
+		ast.mk_method(mut::MUTATING, map_cls, "clear", FN(ag_m_sys_##NAME##_clear), new ast::ConstVoid, {});       \
+		ast.mk_method(mut::MUTATING, map_cls, "delete", FN(ag_m_sys_##NAME##_delete), val_res, { KEY });           \
+		ast.mk_method(mut::ANY, map_cls, "getAt", FN(ag_m_sys_##NAME##_getAt), val_res, { KEY });                  \
+		ast.mk_method(mut::MUTATING, map_cls, "setAt", FN(ag_m_sys_##NAME##_setAt), val_res, { KEY, VAL });        \
+		ast.mk_method(mut::ANY, map_cls, "lowerBound", FN(ag_m_sys_##NAME##_lowerBound), new ast::ConstInt64, { KEY }); \
+		ast.mk_method(mut::ANY, map_cls, "upperBound", FN(ag_m_sys_##NAME##_upperBound), new ast::ConstInt64, { KEY }); \
+		ast.mk_method(mut::ANY, map_cls, "keyAt", FN(ag_m_sys_##NAME##_keyAt), KEY_RES, { ast.tp_int64() });       \
+		ast.mk_method(mut::ANY, map_cls, "valAt", FN(ag_m_sys_##NAME##_valAt), val_res, { ast.tp_int64() });       \
+		ast.mk_method(mut::MUTATING, map_cls, "removeAt", FN(ag_m_sys_##NAME##_removeAt), new ast::ConstVoid, { ast.tp_int64() }); \
+	}
+#define AG_SORTED_SET(NAME, KEY, KEY_RES)                                                                          \
+	{                                                                                                              \
+		auto set_cls = mk_sorted_map_class(#NAME);                                                                 \
+		ast.mk_method(mut::ANY, set_cls, "size", FN(ag_m_sys_##NAME##_size), new ast::ConstInt64, {});             \
+		ast.mk_method(mut::MUTATING, set_cls, "clear", FN(ag_m_sys_##NAME##_clear), new ast::ConstVoid, {});       \
+		ast.mk_method(mut::ANY, set_cls, "contains", FN(ag_m_sys_##NAME##_contains), new ast::ConstBool, { KEY }); \
+		ast.mk_method(mut::MUTATING, set_cls, "add", FN(ag_m_sys_##NAME##_add), new ast::ConstBool, { KEY });      \
+		ast.mk_method(mut::MUTATING, set_cls, "delete", FN(ag_m_sys_##NAME##_delete), new ast::ConstBool, { KEY }); \
+		ast.mk_method(mut::ANY, set_cls, "lowerBound", FN(ag_m_sys_##NAME##_lowerBound), new ast::ConstInt64, { KEY }); \
+		ast.mk_method(mut::ANY, set_cls, "upperBound", FN(ag_m_sys_##NAME##_upperBound), new ast::ConstInt64, { KEY }); \
+		ast.mk_method(mut::ANY, set_cls, "keyAt", FN(ag_m_sys_##NAME##_keyAt), KEY_RES, { ast.tp_int64() });       \
+		ast.mk_method(mut::MUTATING, set_cls, "removeAt", FN(ag_m_sys_##NAME##_removeAt), new ast::ConstVoid, { ast.tp_int64() }); \
 	}
+#define AG_STR_KEY_RES make_opt_result(make_ptr_result(new ast::FreezeOp, ast.string_cls))
+	AG_SORTED_MAP(SortedIntMap, ast.tp_int64(), new ast::ConstInt64,
+		make_opt_result(make_ptr_result(new ast::RefOp, val_cls)), ast.get_own(val_cls))
+	AG_SORTED_MAP(SharedSortedIntMap, ast.tp_int64(), new ast::ConstInt64,
+		make_opt_result(make_ptr_result(new ast::FreezeOp, val_cls)), ast.get_shared(val_cls))
+	AG_SORTED_MAP(WeakSortedIntMap, ast.tp_int64(), new ast::ConstInt64,
+		make_ptr_result(new ast::MkWeakOp, val_cls), ast.get_weak(val_cls))
+	AG_SORTED_SET(SortedIntSet, ast.tp_int64(), new ast::ConstInt64)
+	AG_SORTED_MAP(SortedStrMap, str_key, AG_STR_KEY_RES,
+		make_opt_result(make_ptr_result(new ast::RefOp, val_cls)), ast.get_own(val_cls))
+	AG_SORTED_MAP(SharedSortedStrMap, str_key, AG_STR_KEY_RES,
+		make_opt_result(make_ptr_result(new ast::FreezeOp, val_cls)), ast.get_shared(val_cls))
+	AG_SORTED_MAP(WeakSortedStrMap, str_key, AG_STR_KEY_RES,
+		make_ptr_result(new ast::MkWeakOp, val_cls), ast.get_weak(val_cls))
+	AG_SORTED_SET(SortedStrSet, str_key, AG_STR_KEY_RES)
+#undef AG_STR_KEY_RES
+#undef AG_SORTED_MAP
+#undef AG_SORTED_SET
 	ast.mk_fn("getParent", FN(ag_fn_sys_getParent), opt_ref_to_object, { ast.get_conform_ref(ast.object) });
 	ast.mk_fn("log", FN(ag_fn_sys_log), new ast::ConstVoid, { ast.get_conform_ref(ast.string_cls) });
 	ast.mk_fn("hash", FN(ag_fn_sys_hash), new ast::ConstInt64, { ast.get_shared(ast.object) });
+	ast.mk_fn("keyIndex", FN(ag_fn_sys_keyIndex), new ast::ConstInt64, { ast.get_shared(ast.string_cls), ast.get_shared(ast.string_cls) });
+	ast.mk_fn("intern", FN(ag_fn_sys_intern), new ast::ConstString, { ast.get_shared(ast.string_cls) });
+	ast.mk_fn("internedCount", FN(ag_fn_sys_internedCount), new ast::ConstInt64, {});
+	ast.mk_fn("internedBytes", FN(ag_fn_sys_internedBytes), new ast::ConstInt64, {});
+	ast.mk_fn("internLookups", FN(ag_fn_sys_internLookups), new ast::ConstInt64, {});
+	ast.mk_fn("internHits", FN(ag_fn_sys_internHits), new ast::ConstInt64, {});
 	ast.mk_fn("nowMs", FN(ag_fn_sys_nowMs), new ast::ConstInt64, {});
 	ast.mk_fn("terminate", FN(ag_fn_sys_terminate), new ast::Break, { ast.tp_int64() });
 	ast.mk_fn("setMainObject", FN(ag_fn_sys_setMainObject), new ast::ConstVoid, { ast.tp_optional(ast.get_ref(ast.object))});
@@ -268,6 +573,42 @@ void register_runtime_content(struct ast::Ast& ast) {
 		{ "ag_copy_sys_WeakMap", FN(ag_copy_sys_WeakMap) },
 		{ "ag_dtor_sys_WeakMap",FN(ag_dtor_sys_WeakMap) },
 		{ "ag_visit_sys_WeakMap", FN(ag_visit_sys_WeakMap) },
+		{ "ag_copy_sys_IntMap", FN(ag_copy_sys_IntMap) },
+		{ "ag_dtor_sys_IntMap", FN(ag_dtor_sys_IntMap) },
+		{ "ag_visit_sys_IntMap", FN(ag_visit_sys_IntMap) },
+		{ "ag_copy_sys_SharedIntMap", FN(ag_copy_sys_SharedIntMap) },
+		{ "ag_dtor_sys_SharedIntMap", FN(ag_dtor_sys_SharedIntMap) },
+		{ "ag_visit_sys_SharedIntMap", FN(ag_visit_sys_SharedIntMap) },
+		{ "ag_copy_sys_WeakIntMap", FN(ag_copy_sys_WeakIntMap) },
+		{ "ag_dtor_sys_WeakIntMap", FN(ag_dtor_sys_WeakIntMap) },
+		{ "ag_visit_sys_WeakIntMap", FN(ag_visit_sys_WeakIntMap) },
+		{ "ag_copy_sys_IntSet", FN(ag_copy_sys_IntSet) },
+		{ "ag_dtor_sys_IntSet", FN(ag_dtor_sys_IntSet) },
+		{ "ag_visit_sys_IntSet", FN(ag_visit_sys_IntSet) },
+		{ "ag_copy_sys_SortedIntMap", FN(ag_copy_sys_SortedIntMap) },
+		{ "ag_dtor_sys_SortedIntMap", FN(ag_dtor_sys_SortedIntMap) },
+		{ "ag_visit_sys_SortedIntMap", FN(ag_visit_sys_SortedIntMap) },
+		{ "ag_copy_sys_SharedSortedIntMap", FN(ag_copy_sys_SharedSortedIntMap) },
+		{ "ag_dtor_sys_SharedSortedIntMap", FN(ag_dtor_sys_SharedSortedIntMap) },
+		{ "ag_visit_sys_SharedSortedIntMap", FN(ag_visit_sys_SharedSortedIntMap) },
+		{ "ag_copy_sys_WeakSortedIntMap", FN(ag_copy_sys_WeakSortedIntMap) },
+		{ "ag_dtor_sys_WeakSortedIntMap", FN(ag_dtor_sys_WeakSortedIntMap) },
+		{ "ag_visit_sys_WeakSortedIntMap", FN(ag_visit_sys_WeakSortedIntMap) },
+		{ "ag_copy_sys_SortedIntSet", FN(ag_copy_sys_SortedIntSet) },
+		{ "ag_dtor_sys_SortedIntSet", FN(ag_dtor_sys_SortedIntSet) },
+		{ "ag_visit_sys_SortedIntSet", FN(ag_visit_sys_SortedIntSet) },
+		{ "ag_copy_sys_SortedStrMap", FN(ag_copy_sys_SortedStrMap) },
+		{ "ag_dtor_sys_SortedStrMap", FN(ag_dtor_sys_SortedStrMap) },
+		{ "ag_visit_sys_SortedStrMap", FN(ag_visit_sys_SortedStrMap) },
+		{ "ag_copy_sys_SharedSortedStrMap", FN(ag_copy_sys_SharedSortedStrMap) },
+		{ "ag_dtor_sys_SharedSortedStrMap", FN(ag_dtor_sys_SharedSortedStrMap) },
+		{ "ag_visit_sys_SharedSortedStrMap", FN(ag_visit_sys_SharedSortedStrMap) },
+		{ "ag_copy_sys_WeakSortedStrMap", FN(ag_copy_sys_WeakSortedStrMap) },
+		{ "ag_dtor_sys_WeakSortedStrMap", FN(ag_dtor_sys_WeakSortedStrMap) },
+		{ "ag_visit_sys_WeakSortedStrMap", FN(ag_visit_sys_WeakSortedStrMap) },
+		{ "ag_copy_sys_SortedStrSet", FN(ag_copy_sys_SortedStrSet) },
+		{ "ag_dtor_sys_SortedStrSet", FN(ag_dtor_sys_SortedStrSet) },
+		{ "ag_visit_sys_SortedStrSet", FN(ag_visit_sys_SortedStrSet) },
 		{ "ag_copy_sys_Array", FN(ag_copy_sys_Array) },
 		{ "ag_dtor_sys_Array",FN(ag_dtor_sys_Array) },
 		{ "ag_visit_sys_Array",FN(ag_visit_sys_Array) },
@@ -277,6 +618,33 @@ void register_runtime_content(struct ast::Ast& ast) {
 		{ "ag_copy_sys_WeakArray", FN(ag_copy_sys_WeakArray) },
 		{ "ag_dtor_sys_WeakArray", FN(ag_dtor_sys_WeakArray) },
 		{ "ag_visit_sys_WeakArray", FN(ag_visit_sys_WeakArray) },
+		{ "ag_copy_sys_Int32Array", FN(ag_copy_sys_Int32Array) },
+		{ "ag_dtor_sys_Int32Array", FN(ag_dtor_sys_Int32Array) },
+		{ "ag_visit_sys_Int32Array", FN(ag_visit_sys_Int32Array) },
+		{ "ag_copy_sys_Int64Array", FN(ag_copy_sys_Int64Array) },
+		{ "ag_dtor_sys_Int64Array", FN(ag_dtor_sys_Int64Array) },
+		{ "ag_visit_sys_Int64Array", FN(ag_visit_sys_Int64Array) },
+		{ "ag_copy_sys_FloatArray", FN(ag_copy_sys_FloatArray) },
+		{ "ag_dtor_sys_FloatArray", FN(ag_dtor_sys_FloatArray) },
+		{ "ag_visit_sys_FloatArray", FN(ag_visit_sys_FloatArray) },
+		{ "ag_copy_sys_DoubleArray", FN(ag_copy_sys_DoubleArray) },
+		{ "ag_dtor_sys_DoubleArray", FN(ag_dtor_sys_DoubleArray) },
+		{ "ag_visit_sys_DoubleArray", FN(ag_visit_sys_DoubleArray) },
+		{ "ag_copy_sys_PriorityQueue", FN(ag_copy_sys_PriorityQueue) },
+		{ "ag_dtor_sys_PriorityQueue", FN(ag_dtor_sys_PriorityQueue) },
+		{ "ag_visit_sys_PriorityQueue", FN(ag_visit_sys_PriorityQueue) },
+		{ "ag_copy_sys_DoublePriorityQueue", FN(ag_copy_sys_DoublePriorityQueue) },
+		{ "ag_dtor_sys_DoublePriorityQueue", FN(ag_dtor_sys_DoublePriorityQueue) },
+		{ "ag_visit_sys_DoublePriorityQueue", FN(ag_visit_sys_DoublePriorityQueue) },
+		{ "ag_copy_sys_Deque", FN(ag_copy_sys_Deque) },
+		{ "ag_dtor_sys_Deque", FN(ag_dtor_sys_Deque) },
+		{ "ag_visit_sys_Deque", FN(ag_visit_sys_Deque) },
+		{ "ag_copy_sys_SharedDeque", FN(ag_copy_sys_SharedDeque) },
+		{ "ag_dtor_sys_SharedDeque", FN(ag_dtor_sys_SharedDeque) },
+		{ "ag_visit_sys_SharedDeque", FN(ag_visit_sys_SharedDeque) },
+		{ "ag_copy_sys_WeakDeque", FN(ag_copy_sys_WeakDeque) },
+		{ "ag_dtor_sys_WeakDeque", FN(ag_dtor_sys_WeakDeque) },
+		{ "ag_visit_sys_WeakDeque", FN(ag_visit_sys_WeakDeque) },
 		{ "ag_copy_sys_Thread", FN(ag_copy_sys_Thread) },
 		{ "ag_dtor_sys_Thread", FN(ag_dtor_sys_Thread) },
 		{ "ag_visit_sys_Thread", FN(ag_visit_sys_Thread) } });
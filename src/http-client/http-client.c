@@ -46,7 +46,7 @@ static size_t header_callback(char* buffer, size_t isize, size_t nitems, void* u
 	size_t size = nitems * isize;
 	char* delim = memchr(buffer, ':', size);
 	if (delim) {
-		AgObject* key = &ag_make_str(buffer, delim - buffer)->head;
+		AgObject* key = &ag_make_interned_str(buffer, delim - buffer)->head;  // header names repeat in every response
 		for (delim++; delim < buffer + size && *delim == ' ';)
 			delim++;
 		char* last = buffer + size - 1;
@@ -19,6 +19,14 @@ void AG_NAME(ag_m_sys_, Array_delete) (AgBaseArray* c, uint64_t index, uint64_t
 	ag_delete_container_items(c, index, count);
 }
 
+void AG_NAME(ag_m_sys_, Array_reserve)(AgBaseArray* c, uint64_t items_count) {
+	ag_reserve_container(c, items_count);
+}
+
+void AG_NAME(ag_m_sys_, Array_shrinkToFit)(AgBaseArray* c) {
+	ag_shrink_container(c);
+}
+
 bool AG_NAME(ag_m_sys_, Array_move)(AgBaseArray* c, uint64_t x, uint64_t y, uint64_t z) {
 	return ag_move_container_items(c, x, y, z);
 }
@@ -49,7 +57,7 @@ void AG_NAME(ag_dtor_sys_, Array) (AgBaseArray* c) {
 }
 
 void AG_NAME(ag_copy_sys_, Array) (AgBaseArray* d, AgBaseArray* s) {
-	d->items_count = s->items_count;
+	d->items_count = d->items_allocated = s->items_count;
 	d->items = (void**) ag_alloc(sizeof(void*) * d->items_count);
     void** from = s->items;
 	void** to = d->items;
@@ -1,33 +1,83 @@
 #include "array/array-base.h"
 
-void ag_insert_into_container(AgBaseArray* c, uint64_t at, uint64_t count){
+void ag_reserve_items(AgBaseArray* c, uint64_t items_count, size_t item_size) {
+	if (items_count <= c->items_allocated)
+		return;
+	c->items = (void**)ag_realloc(c->items, items_count * item_size);
+	c->items_allocated = items_count;
+}
+
+void ag_shrink_items(AgBaseArray* c, size_t item_size) {
+	if (c->items_allocated == c->items_count)
+		return;
+	if (c->items_count) {
+		c->items = (void**)ag_realloc(c->items, c->items_count * item_size);
+	} else {
+		ag_free(c->items);
+		c->items = NULL;
+	}
+	c->items_allocated = c->items_count;
+}
+
+void ag_insert_items(AgBaseArray* c, uint64_t at, uint64_t count, size_t item_size) {
 	if (!count || at > c->items_count)
 		return;
-	void** new_data = (void**)ag_alloc((c->items_count + count) * sizeof(void*));
-	ag_memcpy(new_data, c->items, at * sizeof(void*));
-	ag_zero_mem(new_data + at, count * sizeof(void*));
-	ag_memcpy(new_data + at + count, c->items + at, (c->items_count - at) * sizeof(void*));
-	ag_free(c->items);
-	c->items = new_data;
-	c->items_count += count;
+	uint64_t new_count = c->items_count + count;
+	if (new_count > c->items_allocated) {
+		uint64_t grown = c->items_allocated + c->items_allocated / 2 + 4;
+		ag_reserve_items(c, new_count > grown ? new_count : grown, item_size);
+	}
+	int8_t* items = (int8_t*)c->items;
+	ag_memmove(items + (at + count) * item_size, items + at * item_size, (c->items_count - at) * item_size);
+	ag_zero_mem(items + at * item_size, count * item_size);
+	c->items_count = new_count;
+}
+
+void ag_delete_items(AgBaseArray* c, uint64_t at, uint64_t count, size_t item_size) {
+	int8_t* items = (int8_t*)c->items;
+	ag_memmove(items + at * item_size, items + (at + count) * item_size, (c->items_count - at - count) * item_size);
+	c->items_count -= count;
+}
+
+void ag_reserve_container(AgBaseArray* c, uint64_t items_count) {
+	ag_reserve_items(c, items_count, sizeof(void*));
+}
+
+void ag_shrink_container(AgBaseArray* c) {
+	ag_shrink_items(c, sizeof(void*));
+}
+
+void ag_insert_into_container(AgBaseArray* c, uint64_t at, uint64_t count) {
+	ag_insert_items(c, at, count, sizeof(void*));
+}
+
+static void ag_reverse_items(void** from, void** to) {
+	for (to--; from < to; from++, to--) {
+		void* t = *from;
+		*from = *to;
+		*to = t;
+	}
 }
 
 bool ag_move_container_items(AgBaseArray* c, uint64_t x, uint64_t y, uint64_t z) {
 	if (x >= y || y >= z || z > c->items_count)
 		return false;
-	void** temp = (void**)ag_alloc(sizeof(void*) * (y - x));
-	ag_memmove(temp, c->items + x, sizeof(void*) * (y - x));
-	ag_memmove(c->items + x, c->items + y, sizeof(void*) * (z - y));
-	ag_memmove(c->items + x + (z - y), temp, sizeof(void*) * (y - x));
-	ag_free(temp);
+	if (y - x == 1) {  // common case: moving one item forward
+		void* t = c->items[x];
+		ag_memmove(c->items + x, c->items + y, sizeof(void*) * (z - y));
+		c->items[z - 1] = t;
+	} else if (z - y == 1) {  // moving one item backward
+		void* t = c->items[y];
+		ag_memmove(c->items + x + 1, c->items + x, sizeof(void*) * (y - x));
+		c->items[x] = t;
+	} else {  // swap spans in place by three reversals
+		ag_reverse_items(c->items + x, c->items + y);
+		ag_reverse_items(c->items + y, c->items + z);
+		ag_reverse_items(c->items + x, c->items + z);
+	}
 	return true;
 }
 
 void ag_delete_container_items(AgBaseArray* c, uint64_t at, uint64_t count) {
-	void** new_data = (void**)ag_alloc((c->items_count - count) * sizeof(void*));
-	ag_memcpy(new_data, c->items, at * sizeof(void*));
-	ag_memcpy(new_data + at, c->items + at + count, (c->items_count - at - count) * sizeof(void*));
-	ag_free(c->items);
-	c->items = new_data;
-	c->items_count -= count;
+	ag_delete_items(c, at, count, sizeof(void*));
 }
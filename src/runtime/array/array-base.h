@@ -6,8 +6,15 @@ typedef struct {
 	AgObject head;
 	uint64_t items_count;
 	void** items;
+	uint64_t items_allocated;  // >= items_count, grows geometrically
 } AgBaseArray;
 
+// Entry points of delegates passed to sorting and searching functions, the first parameter is a delegate receiver
+typedef bool      (*AgSortLess)     (AgObject* receiver, AgObject* a, AgObject* b);
+typedef bool      (*AgSortPredicate)(AgObject* receiver, AgObject* item);
+typedef int64_t   (*AgSortIntKey)   (AgObject* receiver, AgObject* item);
+typedef AgString* (*AgSortStrKey)   (AgObject* receiver, AgObject* item);
+
 // Inserts empty elements into a container
 void ag_insert_into_container(AgBaseArray* c, uint64_t at, uint64_t items_count);
 
@@ -19,4 +26,16 @@ bool ag_move_container_items(AgBaseArray* c, uint64_t x, uint64_t y, uint64_t z)
 // Removes elements from a container (no dispose)
 void ag_delete_container_items(AgBaseArray* b, uint64_t index, uint64_t count);
 
+// Makes container able to hold `items_count` elements without reallocations
+void ag_reserve_container(AgBaseArray* c, uint64_t items_count);
+
+// Frees unused preallocated space
+void ag_shrink_container(AgBaseArray* c);
+
+// Same operations on containers of unboxed `item_size`-byte items, the functions above use pointer-sized items.
+void ag_reserve_items(AgBaseArray* c, uint64_t items_count, size_t item_size);
+void ag_shrink_items (AgBaseArray* c, size_t item_size);
+void ag_insert_items (AgBaseArray* c, uint64_t at, uint64_t items_count, size_t item_size);
+void ag_delete_items (AgBaseArray* c, uint64_t at, uint64_t count, size_t item_size);  // no bounds check
+
 #endif // AG_ARRAY_BASE_H_
@@ -0,0 +1,240 @@
+// Sorting algorithms instantiated in array-sort.c for every item type.
+// Expects:
+//   AG_SORT_NAME(SUFFIX) - makes a function name,
+//   AG_SORT_T - item type,
+//   AG_SORT_LESS(CTX, A, B) - strict weak ordering.
+// Optional:
+//   AG_SORT_NO_UNSTABLE - skips `_sort` and `_nth`,
+//   AG_SORT_NO_STABLE - skips `_stable_sort`.
+// All loops are bounds-guarded, so an inconsistent user comparator produces an unspecified order but never
+// accesses items outside the sorted range.
+
+#define AG_SORT_SWAP(A, B) { AG_SORT_T t_ = (A); (A) = (B); (B) = t_; }
+
+static void AG_SORT_NAME(_insertion)(AG_SORT_T* a, size_t n, void* ctx) {
+	for (size_t i = 1; i < n; i++) {
+		AG_SORT_T t = a[i];
+		size_t j = i;
+		for (; j > 0 && AG_SORT_LESS(ctx, t, a[j - 1]); j--)
+			a[j] = a[j - 1];
+		a[j] = t;
+	}
+}
+
+#ifndef AG_SORT_NO_UNSTABLE
+
+// Insertion sort that gives up after a few moves, returns true if range got sorted
+static bool AG_SORT_NAME(_partial_insertion)(AG_SORT_T* a, size_t n, void* ctx) {
+	size_t moves = 0;
+	for (size_t i = 1; i < n; i++) {
+		if (!AG_SORT_LESS(ctx, a[i], a[i - 1]))
+			continue;
+		AG_SORT_T t = a[i];
+		size_t j = i;
+		for (; j > 0 && AG_SORT_LESS(ctx, t, a[j - 1]); j--)
+			a[j] = a[j - 1];
+		a[j] = t;
+		if ((moves += i - j) > 8)
+			return false;
+	}
+	return true;
+}
+
+static void AG_SORT_NAME(_sift_down)(AG_SORT_T* a, size_t i, size_t n, void* ctx) {
+	AG_SORT_T t = a[i];
+	for (;;) {
+		size_t c = i * 2 + 1;
+		if (c >= n)
+			break;
+		if (c + 1 < n && AG_SORT_LESS(ctx, a[c], a[c + 1]))
+			c++;
+		if (!AG_SORT_LESS(ctx, t, a[c]))
+			break;
+		a[i] = a[c];
+		i = c;
+	}
+	a[i] = t;
+}
+
+static void AG_SORT_NAME(_heap)(AG_SORT_T* a, size_t n, void* ctx) {
+	for (size_t i = n / 2; i-- > 0;)
+		AG_SORT_NAME(_sift_down)(a, i, n, ctx);
+	for (size_t i = n; i-- > 1;) {
+		AG_SORT_SWAP(a[0], a[i]);
+		AG_SORT_NAME(_sift_down)(a, 0, i, ctx);
+	}
+}
+
+// Orders a[i] <= a[j] <= a[k]
+static void AG_SORT_NAME(_sort3)(AG_SORT_T* a, size_t i, size_t j, size_t k, void* ctx) {
+	if (AG_SORT_LESS(ctx, a[j], a[i])) AG_SORT_SWAP(a[i], a[j]);
+	if (AG_SORT_LESS(ctx, a[k], a[j])) AG_SORT_SWAP(a[j], a[k]);
+	if (AG_SORT_LESS(ctx, a[j], a[i])) AG_SORT_SWAP(a[i], a[j]);
+}
+
+// Moves median of several items to a[0]
+static void AG_SORT_NAME(_choose_pivot)(AG_SORT_T* a, size_t n, void* ctx) {
+	size_t h = n / 2;
+	if (n > 128) {  // ninther
+		AG_SORT_NAME(_sort3)(a, 0, h, n - 1, ctx);
+		AG_SORT_NAME(_sort3)(a, 1, h - 1, n - 2, ctx);
+		AG_SORT_NAME(_sort3)(a, 2, h + 1, n - 3, ctx);
+		AG_SORT_NAME(_sort3)(a, h - 1, h, h + 1, ctx);
+		AG_SORT_SWAP(a[0], a[h]);
+	} else {
+		AG_SORT_NAME(_sort3)(a, h, 0, n - 1, ctx);
+	}
+}
+
+// Partitions around pivot a[0], items equal to pivot go right. Returns the final pivot position.
+static size_t AG_SORT_NAME(_partition_right)(AG_SORT_T* a, size_t n, void* ctx, bool* already_partitioned) {
+	AG_SORT_T pivot = a[0];
+	size_t first = 1, last = n;
+	while (first < last && AG_SORT_LESS(ctx, a[first], pivot)) first++;
+	while (first < last && !AG_SORT_LESS(ctx, a[last - 1], pivot)) last--;
+	*already_partitioned = first >= last;
+	while (first < last) {
+		AG_SORT_SWAP(a[first], a[last - 1]);
+		first++;
+		last--;
+		while (first < last && AG_SORT_LESS(ctx, a[first], pivot)) first++;
+		while (first < last && !AG_SORT_LESS(ctx, a[last - 1], pivot)) last--;
+	}
+	a[0] = a[first - 1];
+	a[first - 1] = pivot;
+	return first - 1;
+}
+
+// Partitions around pivot a[0], items equal to pivot go left. Returns the final pivot position.
+static size_t AG_SORT_NAME(_partition_left)(AG_SORT_T* a, size_t n, void* ctx) {
+	AG_SORT_T pivot = a[0];
+	size_t first = 1, last = n;
+	while (first < last && AG_SORT_LESS(ctx, pivot, a[last - 1])) last--;
+	while (first < last && !AG_SORT_LESS(ctx, pivot, a[first])) first++;
+	while (first < last) {
+		AG_SORT_SWAP(a[first], a[last - 1]);
+		first++;
+		last--;
+		while (first < last && AG_SORT_LESS(ctx, pivot, a[last - 1])) last--;
+		while (first < last && !AG_SORT_LESS(ctx, pivot, a[first])) first++;
+	}
+	a[0] = a[last - 1];
+	a[last - 1] = pivot;
+	return last - 1;
+}
+
+// Pattern-defeating quicksort: falls back to heap sort on repeatedly bad pivots,
+// skips runs of items equal to the previous pivot, and finishes nearly sorted ranges with insertion sort.
+static void AG_SORT_NAME(_pdq)(AG_SORT_T* a, size_t n, void* ctx, int bad_allowed, bool leftmost) {
+	for (;;) {
+		if (n < 24) {
+			AG_SORT_NAME(_insertion)(a, n, ctx);
+			return;
+		}
+		AG_SORT_NAME(_choose_pivot)(a, n, ctx);
+		if (!leftmost && !AG_SORT_LESS(ctx, a[-1], a[0])) {  // a[-1] is the previous pivot
+			size_t p = AG_SORT_NAME(_partition_left)(a, n, ctx);
+			a += p + 1;
+			n -= p + 1;
+			continue;
+		}
+		bool already_partitioned;
+		size_t p = AG_SORT_NAME(_partition_right)(a, n, ctx, &already_partitioned);
+		size_t l = p, r = n - p - 1;
+		if (l < n / 8 || r < n / 8) {
+			if (--bad_allowed == 0) {
+				AG_SORT_NAME(_heap)(a, n, ctx);
+				return;
+			}
+			if (l >= 24) {
+				AG_SORT_SWAP(a[0], a[l / 4]);
+				AG_SORT_SWAP(a[p - 1], a[p - l / 4]);
+			}
+			if (r >= 24) {
+				AG_SORT_SWAP(a[p + 1], a[p + 1 + r / 4]);
+				AG_SORT_SWAP(a[n - 1], a[n - r / 4]);
+			}
+		} else if (already_partitioned &&
+			AG_SORT_NAME(_partial_insertion)(a, l, ctx) &&
+			AG_SORT_NAME(_partial_insertion)(a + p + 1, r, ctx)) {
+			return;
+		}
+		if (l < r) {
+			AG_SORT_NAME(_pdq)(a, l, ctx, bad_allowed, leftmost);
+			a += p + 1;
+			n = r;
+			leftmost = false;
+		} else {
+			AG_SORT_NAME(_pdq)(a + p + 1, r, ctx, bad_allowed, false);
+			n = l;
+		}
+	}
+}
+
+static void AG_SORT_NAME(_sort)(AG_SORT_T* a, size_t n, void* ctx) {
+	int log2 = 0;
+	for (size_t i = n; i > 1; i >>= 1)
+		log2++;
+	AG_SORT_NAME(_pdq)(a, n, ctx, log2 + 1, true);
+}
+
+// Quickselect: puts the k-th item in its sorted position, smaller items before it, others after it
+static void AG_SORT_NAME(_nth)(AG_SORT_T* a, size_t n, size_t k, void* ctx) {
+	int bad_allowed = 64;
+	while (n >= 24) {
+		if (--bad_allowed == 0) {
+			AG_SORT_NAME(_heap)(a, n, ctx);
+			return;
+		}
+		AG_SORT_NAME(_choose_pivot)(a, n, ctx);
+		bool already_partitioned;
+		size_t p = AG_SORT_NAME(_partition_right)(a, n, ctx, &already_partitioned);
+		if (p == k)
+			return;
+		if (k < p) {
+			n = p;
+		} else {
+			a += p + 1;
+			n -= p + 1;
+			k -= p + 1;
+		}
+	}
+	AG_SORT_NAME(_insertion)(a, n, ctx);
+}
+
+#endif // AG_SORT_NO_UNSTABLE
+
+#ifndef AG_SORT_NO_STABLE
+
+// Top-down merge sort, `buf` must hold n / 2 items
+static void AG_SORT_NAME(_merge_sort)(AG_SORT_T* a, size_t n, AG_SORT_T* buf, void* ctx) {
+	if (n <= 16) {
+		AG_SORT_NAME(_insertion)(a, n, ctx);
+		return;
+	}
+	size_t h = n / 2;
+	AG_SORT_NAME(_merge_sort)(a, h, buf, ctx);
+	AG_SORT_NAME(_merge_sort)(a + h, n - h, buf, ctx);
+	if (!AG_SORT_LESS(ctx, a[h], a[h - 1]))
+		return;
+	ag_memcpy(buf, a, h * sizeof(AG_SORT_T));
+	size_t i = 0, j = h, k = 0;
+	while (i < h && j < n)
+		a[k++] = AG_SORT_LESS(ctx, a[j], buf[i]) ? a[j++] : buf[i++];
+	while (i < h)
+		a[k++] = buf[i++];
+}
+
+static void AG_SORT_NAME(_stable_sort)(AG_SORT_T* a, size_t n, void* ctx) {
+	if (n <= 16) {
+		AG_SORT_NAME(_insertion)(a, n, ctx);
+		return;
+	}
+	AG_SORT_T* buf = (AG_SORT_T*)ag_alloc(n / 2 * sizeof(AG_SORT_T));
+	AG_SORT_NAME(_merge_sort)(a, n, buf, ctx);
+	ag_free(buf);
+}
+
+#endif // AG_SORT_NO_STABLE
+
+#undef AG_SORT_SWAP
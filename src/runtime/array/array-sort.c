@@ -0,0 +1,329 @@
+#include <string.h>
+#include "array/own-array.h"
+#include "array/shared-array.h"
+#include "array/typed-array.h"
+
+//
+// Arrays of objects, ordered by Argentum delegates
+//
+
+typedef struct {
+	AgObject* receiver;  // pinned delegate receiver
+	void*     entry_point;
+} AgSortCtx;
+
+typedef struct {
+	int64_t key;
+	void*   item;
+} AgIntKeyedItem;
+
+typedef struct {
+	AgString* key;
+	void*     item;
+} AgStrKeyedItem;
+
+// Argentum bool results define only the lowest bit of the return register
+#define AG_CALL_LESS(CTX, A, B) (((AgSortLess)((AgSortCtx*)(CTX))->entry_point)(((AgSortCtx*)(CTX))->receiver, (AgObject*)(A), (AgObject*)(B)) & 1)
+#define AG_CALL_PREDICATE(CTX, ITEM) (((AgSortPredicate)(CTX)->entry_point)((CTX)->receiver, (AgObject*)(ITEM)) & 1)
+
+#define AG_SORT_NAME(SUFFIX) ag_obj##SUFFIX
+#define AG_SORT_T void*
+#define AG_SORT_LESS(CTX, A, B) AG_CALL_LESS(CTX, A, B)
+#include "array-sort-inc.h"
+#undef AG_SORT_NAME
+#undef AG_SORT_T
+#undef AG_SORT_LESS
+
+#define AG_SORT_NO_UNSTABLE
+#define AG_SORT_NAME(SUFFIX) ag_int_keyed##SUFFIX
+#define AG_SORT_T AgIntKeyedItem
+#define AG_SORT_LESS(CTX, A, B) ((A).key < (B).key)
+#include "array-sort-inc.h"
+#undef AG_SORT_NAME
+#undef AG_SORT_T
+#undef AG_SORT_LESS
+
+#define AG_SORT_NAME(SUFFIX) ag_str_keyed##SUFFIX
+#define AG_SORT_T AgStrKeyedItem
+#define AG_SORT_LESS(CTX, A, B) (ag_compare_strings((A).key, (B).key) < 0)
+#include "array-sort-inc.h"
+#undef AG_SORT_NAME
+#undef AG_SORT_T
+#undef AG_SORT_LESS
+#undef AG_SORT_NO_UNSTABLE
+
+// Returns false if delegate receiver is gone
+static bool ag_init_sort_ctx(AgSortCtx* ctx, AgWeak* receiver, void* entry_point) {
+	ctx->receiver = ag_deref_weak(receiver);
+	ctx->entry_point = entry_point;
+	return ctx->receiver != NULL;
+}
+
+// Items are taken away from the array while Argentum callbacks run, so callbacks see it empty
+// and can't free or move the items being sorted. Items added by callbacks go after the sorted ones.
+typedef struct {
+	void**   items;
+	uint64_t count;
+	uint64_t allocated;
+} AgDetachedItems;
+
+static void ag_detach_items(AgBaseArray* c, AgDetachedItems* d) {
+	d->items = c->items;
+	d->count = c->items_count;
+	d->allocated = c->items_allocated;
+	c->items = NULL;
+	c->items_count = c->items_allocated = 0;
+}
+
+static void ag_reattach_items(AgBaseArray* c, AgDetachedItems* d) {
+	void** added = c->items;
+	uint64_t added_count = c->items_count;
+	c->items = d->items;
+	c->items_count = d->count;
+	c->items_allocated = d->allocated;
+	if (added_count) {
+		uint64_t at = c->items_count;
+		ag_insert_into_container(c, at, added_count);
+		ag_memcpy(c->items + at, added, added_count * sizeof(void*));
+	}
+	ag_free(added);
+}
+
+// Moves null items to the end preserving order of others, returns the number of not null items
+static size_t ag_move_nulls_to_end(void** items, size_t count) {
+	size_t n = 0;
+	for (size_t i = 0; i < count; i++) {
+		if (items[i])
+			items[n++] = items[i];
+	}
+	for (size_t i = n; i < count; i++)
+		items[i] = NULL;
+	return n;
+}
+
+static void ag_sort_array(AgBaseArray* c, AgWeak* receiver, AgSortLess less) {
+	AgSortCtx ctx;
+	if (!ag_init_sort_ctx(&ctx, receiver, less))
+		return;
+	AgDetachedItems d;
+	ag_detach_items(c, &d);
+	ag_obj_sort(d.items, ag_move_nulls_to_end(d.items, d.count), &ctx);
+	ag_reattach_items(c, &d);
+	ag_release_pin(ctx.receiver);
+}
+
+static void ag_stable_sort_array(AgBaseArray* c, AgWeak* receiver, AgSortLess less) {
+	AgSortCtx ctx;
+	if (!ag_init_sort_ctx(&ctx, receiver, less))
+		return;
+	AgDetachedItems d;
+	ag_detach_items(c, &d);
+	ag_obj_stable_sort(d.items, ag_move_nulls_to_end(d.items, d.count), &ctx);
+	ag_reattach_items(c, &d);
+	ag_release_pin(ctx.receiver);
+}
+
+static void ag_nth_element_of_array(AgBaseArray* c, uint64_t k, AgWeak* receiver, AgSortLess less) {
+	AgSortCtx ctx;
+	if (!ag_init_sort_ctx(&ctx, receiver, less))
+		return;
+	AgDetachedItems d;
+	ag_detach_items(c, &d);
+	size_t n = ag_move_nulls_to_end(d.items, d.count);
+	if (k < n)
+		ag_obj_nth(d.items, n, k, &ctx);
+	ag_reattach_items(c, &d);
+	ag_release_pin(ctx.receiver);
+}
+
+static int64_t ag_partition_array(AgBaseArray* c, AgWeak* receiver, AgSortPredicate predicate) {
+	AgSortCtx ctx;
+	if (!ag_init_sort_ctx(&ctx, receiver, predicate))
+		return 0;
+	AgDetachedItems d;
+	ag_detach_items(c, &d);
+	size_t i = 0, j = ag_move_nulls_to_end(d.items, d.count);
+	while (i < j) {
+		if (AG_CALL_PREDICATE(&ctx, d.items[i])) {
+			i++;
+		} else {
+			j--;
+			void* t = d.items[i];
+			d.items[i] = d.items[j];
+			d.items[j] = t;
+		}
+	}
+	ag_reattach_items(c, &d);
+	ag_release_pin(ctx.receiver);
+	return i;
+}
+
+// Doesn't change the array, so it works on frozen arrays shared between threads.
+// Not frozen arrays can be changed by callbacks, so the probed item is retained and bounds get rechecked.
+static int64_t ag_lower_bound_in_array(
+	AgBaseArray* c,
+	AgWeak* receiver,
+	AgSortPredicate is_before,
+	void (*retain)(AgObject*),
+	void (*release)(AgObject*))
+{
+	AgSortCtx ctx;
+	if (!ag_init_sort_ctx(&ctx, receiver, is_before))
+		return 0;
+	size_t lo = 0, hi = c->items_count;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		AgObject* item = (AgObject*)c->items[mid];
+		bool before = false;
+		if (item) {
+			retain(item);
+			before = AG_CALL_PREDICATE(&ctx, item);
+			release(item);
+		}
+		if (before)
+			lo = mid + 1;
+		else
+			hi = mid;
+		if (hi > c->items_count)
+			hi = c->items_count;
+		if (lo > hi)
+			lo = hi;
+	}
+	ag_release_pin(ctx.receiver);
+	return lo;
+}
+
+static void ag_sort_array_by_int(AgBaseArray* c, AgWeak* receiver, AgSortIntKey key) {
+	AgSortCtx ctx;
+	if (!ag_init_sort_ctx(&ctx, receiver, key))
+		return;
+	AgDetachedItems d;
+	ag_detach_items(c, &d);
+	size_t n = ag_move_nulls_to_end(d.items, d.count);
+	AgIntKeyedItem* pairs = (AgIntKeyedItem*)ag_alloc(n * sizeof(AgIntKeyedItem));
+	for (size_t i = 0; i < n; i++) {
+		pairs[i].item = d.items[i];
+		pairs[i].key = key(ctx.receiver, (AgObject*)d.items[i]);
+	}
+	ag_int_keyed_stable_sort(pairs, n, NULL);
+	for (size_t i = 0; i < n; i++)
+		d.items[i] = pairs[i].item;
+	ag_free(pairs);
+	ag_reattach_items(c, &d);
+	ag_release_pin(ctx.receiver);
+}
+
+static void ag_sort_array_by_str(AgBaseArray* c, AgWeak* receiver, AgSortStrKey key) {
+	AgSortCtx ctx;
+	if (!ag_init_sort_ctx(&ctx, receiver, key))
+		return;
+	AgDetachedItems d;
+	ag_detach_items(c, &d);
+	size_t n = ag_move_nulls_to_end(d.items, d.count);
+	AgStrKeyedItem* pairs = (AgStrKeyedItem*)ag_alloc(n * sizeof(AgStrKeyedItem));
+	for (size_t i = 0; i < n; i++) {
+		pairs[i].item = d.items[i];
+		pairs[i].key = key(ctx.receiver, (AgObject*)d.items[i]);
+	}
+	ag_str_keyed_stable_sort(pairs, n, NULL);
+	for (size_t i = 0; i < n; i++) {
+		d.items[i] = pairs[i].item;
+		ag_release_shared(&pairs[i].key->head);
+	}
+	ag_free(pairs);
+	ag_reattach_items(c, &d);
+	ag_release_pin(ctx.receiver);
+}
+
+#define AG_ARRAY_SORT_FNS(NAME, RETAIN, RELEASE)                                                           \
+	void ag_m_sys_##NAME##_sort(AgBaseArray* c, AgWeak* receiver, AgSortLess less) {                       \
+		ag_sort_array(c, receiver, less);                                                                  \
+	}                                                                                                      \
+	void ag_m_sys_##NAME##_stableSort(AgBaseArray* c, AgWeak* receiver, AgSortLess less) {                 \
+		ag_stable_sort_array(c, receiver, less);                                                           \
+	}                                                                                                      \
+	void ag_m_sys_##NAME##_nthElement(AgBaseArray* c, uint64_t k, AgWeak* receiver, AgSortLess less) {     \
+		ag_nth_element_of_array(c, k, receiver, less);                                                     \
+	}                                                                                                      \
+	int64_t ag_m_sys_##NAME##_partition(AgBaseArray* c, AgWeak* receiver, AgSortPredicate predicate) {     \
+		return ag_partition_array(c, receiver, predicate);                                                 \
+	}                                                                                                      \
+	int64_t ag_m_sys_##NAME##_lowerBound(AgBaseArray* c, AgWeak* receiver, AgSortPredicate is_before) {    \
+		return ag_lower_bound_in_array(c, receiver, is_before, RETAIN, RELEASE);                           \
+	}                                                                                                      \
+	void ag_m_sys_##NAME##_sortByInt(AgBaseArray* c, AgWeak* receiver, AgSortIntKey key) {                 \
+		ag_sort_array_by_int(c, receiver, key);                                                            \
+	}                                                                                                      \
+	void ag_m_sys_##NAME##_sortByStr(AgBaseArray* c, AgWeak* receiver, AgSortStrKey key) {                 \
+		ag_sort_array_by_str(c, receiver, key);                                                            \
+	}
+
+AG_ARRAY_SORT_FNS(Array, ag_retain_pin, ag_release_pin)
+AG_ARRAY_SORT_FNS(SharedArray, ag_retain_shared, ag_release_shared)
+
+//
+// Typed arrays, natural order, NaNs go last
+//
+
+#define AG_NUM_LESS(CTX, A, B) ((A) < (B) || ((B) != (B) && (A) == (A)))
+
+#define AG_TYPED_ARRAY_SORT_FNS(NAME, ITEM_TYPE)                                                           \
+	void ag_m_sys_##NAME##_sort(AgTypedArray* c) {                                                         \
+		ag_##NAME##_sort((ITEM_TYPE*)c->items, c->items_count, NULL);                                      \
+	}                                                                                                      \
+	void ag_m_sys_##NAME##_nthElement(AgTypedArray* c, uint64_t k) {                                       \
+		if (k < c->items_count)                                                                            \
+			ag_##NAME##_nth((ITEM_TYPE*)c->items, c->items_count, k, NULL);                                \
+	}                                                                                                      \
+	int64_t ag_m_sys_##NAME##_lowerBound(AgTypedArray* c, ITEM_TYPE val) {                                 \
+		ITEM_TYPE* a = (ITEM_TYPE*)c->items;                                                               \
+		size_t lo = 0, hi = c->items_count;                                                                \
+		while (lo < hi) {                                                                                  \
+			size_t mid = lo + (hi - lo) / 2;                                                               \
+			if (AG_NUM_LESS(0, a[mid], val)) lo = mid + 1; else hi = mid;                                  \
+		}                                                                                                  \
+		return lo;                                                                                         \
+	}                                                                                                      \
+	int64_t ag_m_sys_##NAME##_upperBound(AgTypedArray* c, ITEM_TYPE val) {                                 \
+		ITEM_TYPE* a = (ITEM_TYPE*)c->items;                                                               \
+		size_t lo = 0, hi = c->items_count;                                                                \
+		while (lo < hi) {                                                                                  \
+			size_t mid = lo + (hi - lo) / 2;                                                               \
+			if (AG_NUM_LESS(0, val, a[mid])) hi = mid; else lo = mid + 1;                                  \
+		}                                                                                                  \
+		return lo;                                                                                         \
+	}
+
+#define AG_SORT_LESS(CTX, A, B) AG_NUM_LESS(CTX, A, B)
+#define AG_SORT_NO_STABLE
+
+#define AG_SORT_NAME(SUFFIX) ag_Int32Array##SUFFIX
+#define AG_SORT_T int32_t
+#include "array-sort-inc.h"
+AG_TYPED_ARRAY_SORT_FNS(Int32Array, int32_t)
+#undef AG_SORT_NAME
+#undef AG_SORT_T
+
+#define AG_SORT_NAME(SUFFIX) ag_Int64Array##SUFFIX
+#define AG_SORT_T int64_t
+#include "array-sort-inc.h"
+AG_TYPED_ARRAY_SORT_FNS(Int64Array, int64_t)
+#undef AG_SORT_NAME
+#undef AG_SORT_T
+
+#define AG_SORT_NAME(SUFFIX) ag_FloatArray##SUFFIX
+#define AG_SORT_T float
+#include "array-sort-inc.h"
+AG_TYPED_ARRAY_SORT_FNS(FloatArray, float)
+#undef AG_SORT_NAME
+#undef AG_SORT_T
+
+#define AG_SORT_NAME(SUFFIX) ag_DoubleArray##SUFFIX
+#define AG_SORT_T double
+#include "array-sort-inc.h"
+AG_TYPED_ARRAY_SORT_FNS(DoubleArray, double)
+#undef AG_SORT_NAME
+#undef AG_SORT_T
+
+#undef AG_SORT_LESS
+#undef AG_SORT_NO_STABLE
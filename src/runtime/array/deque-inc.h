@@ -0,0 +1,108 @@
+// Instantiated in own-array.c, shared-array.c and weak-array.c
+// with the same item ownership macros as array-base-inc.h.
+
+#include "array/deque.h"
+
+#define AG_DEQUE_AT(D, I) ((D)->items[((D)->start + (I)) & ((D)->capacity - 1)])
+
+int64_t AG_NAME(ag_m_sys_, Deque_size)(AgDeque* d) {
+	return d->count;
+}
+
+void AG_NAME(ag_m_sys_, Deque_reserve)(AgDeque* d, uint64_t count) {
+	ag_reserve_deque(d, count);
+}
+
+void AG_NAME(ag_m_sys_, Deque_pushBack)(AgDeque* d, AG_ITEM_TYPE val) {
+	if (d->count == d->capacity)
+		ag_reserve_deque(d, d->count + 1);
+	AG_RETAIN_OWN(val, &d->head);
+	AG_DEQUE_AT(d, d->count) = (void*)val;
+	d->count++;
+}
+
+void AG_NAME(ag_m_sys_, Deque_pushFront)(AgDeque* d, AG_ITEM_TYPE val) {
+	if (d->count == d->capacity)
+		ag_reserve_deque(d, d->count + 1);
+	AG_RETAIN_OWN(val, &d->head);
+	d->start = (d->start - 1) & (d->capacity - 1);
+	d->items[d->start] = (void*)val;
+	d->count++;
+}
+
+AG_ITEM_TYPE AG_NAME(ag_m_sys_, Deque_popBack)(AgDeque* d) {
+	if (!d->count)
+		return 0;
+	d->count--;
+	void** slot = &AG_DEQUE_AT(d, d->count);
+	AG_ITEM_TYPE r = (AG_ITEM_TYPE)*slot;
+	*slot = NULL;
+	AG_DETACH(r);
+	return r;
+}
+
+AG_ITEM_TYPE AG_NAME(ag_m_sys_, Deque_popFront)(AgDeque* d) {
+	if (!d->count)
+		return 0;
+	void** slot = d->items + d->start;
+	AG_ITEM_TYPE r = (AG_ITEM_TYPE)*slot;
+	*slot = NULL;
+	d->start = (d->start + 1) & (d->capacity - 1);
+	d->count--;
+	AG_DETACH(r);
+	return r;
+}
+
+AG_ITEM_TYPE AG_NAME(ag_m_sys_, Deque_getAt)(AgDeque* d, uint64_t index) {
+	if (index >= d->count)
+		return 0;
+	void* r = AG_DEQUE_AT(d, index);
+	AG_RETAIN(r);
+	return (AG_ITEM_TYPE)r;
+}
+
+void AG_NAME(ag_m_sys_, Deque_setAt)(AgDeque* d, uint64_t index, AG_ITEM_TYPE val) {
+	if (index < d->count) {
+		void** dst = &AG_DEQUE_AT(d, index);
+		AG_RETAIN_OWN_NN(val, &d->head);
+		AG_RELEASE(*dst);
+		*dst = (void*)val;
+	}
+}
+
+void AG_NAME(ag_m_sys_, Deque_clear)(AgDeque* d) {
+	for (uint64_t i = 0; i < d->count; i++)
+		AG_RELEASE(AG_DEQUE_AT(d, i));
+	ag_free(d->items);
+	d->items = NULL;
+	d->capacity = d->start = d->count = 0;
+}
+
+void AG_NAME(ag_dtor_sys_, Deque)(AgDeque* d) {
+	AG_NAME(ag_m_sys_, Deque_clear)(d);
+}
+
+void AG_NAME(ag_copy_sys_, Deque)(AgDeque* d, AgDeque* s) {
+	d->items = NULL;
+	d->capacity = d->start = d->count = 0;
+	ag_reserve_deque(d, s->count);
+	d->count = s->count;
+	void** to = d->items;
+	for (uint64_t i = 0; i < s->count; i++, to++) {
+		void** from = &AG_DEQUE_AT(s, i);
+		AG_COPY(to, from, &d->head);
+	}
+}
+
+void AG_NAME(ag_visit_sys_, Deque)(
+	AgDeque* d,
+	void(*visitor)(void*, int, void*),
+	void* ctx)
+{
+	if (ag_not_null(d)) {
+		for (uint64_t i = 0; i < d->count; i++)
+			visitor(&AG_DEQUE_AT(d, i), AG_VISIT_KIND, ctx);
+	}
+}
+
+#undef AG_DEQUE_AT
@@ -0,0 +1,21 @@
+#include "array/deque.h"
+
+void ag_reserve_deque(AgDeque* d, uint64_t count) {
+	if (count <= d->capacity)
+		return;
+	uint64_t new_capacity = d->capacity ? d->capacity : 8;
+	while (new_capacity < count)
+		new_capacity <<= 1;
+	void** items = (void**)ag_alloc(new_capacity * sizeof(void*));
+	uint64_t head_part = d->capacity - d->start;  // items till the end of the old buffer
+	if (head_part > d->count)
+		head_part = d->count;
+	if (d->count) {
+		ag_memcpy(items, d->items + d->start, head_part * sizeof(void*));
+		ag_memcpy(items + head_part, d->items, (d->count - head_part) * sizeof(void*));
+	}
+	ag_free(d->items);
+	d->items = items;
+	d->capacity = new_capacity;
+	d->start = 0;
+}
@@ -0,0 +1,48 @@
+#ifndef AG_DEQUE_H_
+#define AG_DEQUE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "runtime.h"
+
+// Ring buffer of object pointers with O(1) push and pop at both ends.
+// Item `i` is stored at `items[(start + i) & (capacity - 1)]`.
+typedef struct {
+	AgObject head;
+	void**   items;
+	uint64_t capacity;  // 0 or power of 2
+	uint64_t start;
+	uint64_t count;
+} AgDeque;
+
+// Makes deque able to hold `count` items without reallocations
+void ag_reserve_deque(AgDeque* d, uint64_t count);
+
+#define AG_DEQUE_DECLS(NAME, ITEM_T)                                                                 \
+	void    ag_copy_sys_##NAME         (AgDeque* dst, AgDeque* src);                                \
+	void    ag_dtor_sys_##NAME         (AgDeque* d);                                                \
+	void    ag_visit_sys_##NAME        (AgDeque* d, void(*visitor)(void*, int, void*), void* ctx);  \
+	int64_t ag_m_sys_##NAME##_size     (AgDeque* d);                                                \
+	void    ag_m_sys_##NAME##_clear    (AgDeque* d);                                                \
+	void    ag_m_sys_##NAME##_reserve  (AgDeque* d, uint64_t count);                                \
+	void    ag_m_sys_##NAME##_pushBack (AgDeque* d, ITEM_T val);                                    \
+	void    ag_m_sys_##NAME##_pushFront(AgDeque* d, ITEM_T val);                                    \
+	ITEM_T  ag_m_sys_##NAME##_popBack  (AgDeque* d);  /* returns detached item or 0 if empty */     \
+	ITEM_T  ag_m_sys_##NAME##_popFront (AgDeque* d);                                                \
+	ITEM_T  ag_m_sys_##NAME##_getAt    (AgDeque* d, uint64_t index);                                \
+	void    ag_m_sys_##NAME##_setAt    (AgDeque* d, uint64_t index, ITEM_T val);
+
+AG_DEQUE_DECLS(Deque, AgObject*)
+AG_DEQUE_DECLS(SharedDeque, AgObject*)
+AG_DEQUE_DECLS(WeakDeque, AgWeak*)
+
+#undef AG_DEQUE_DECLS
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // AG_DEQUE_H_
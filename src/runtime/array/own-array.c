@@ -11,6 +11,9 @@
 
 #include "array-base-inc.h"
 
+#define AG_DETACH(PTR) ag_set_parent((AgObject*)(PTR), NULL)
+#include "deque-inc.h"
+
 AgObject* ag_m_sys_Array_setOptAt(AgBaseArray* c, uint64_t at, AgObject* val) {
 	if (at >= c->items_count)
 		return NULL;
@@ -16,6 +16,8 @@ void      ag_visit_sys_Array      (AgBaseArray* ptr, void(*visitor)(void*, int,
 int64_t   ag_m_sys_Array_capacity (AgBaseArray* c);
 void      ag_m_sys_Array_insert   (AgBaseArray* c, uint64_t at, uint64_t items_count);
 void      ag_m_sys_Array_delete   (AgBaseArray* b, uint64_t index, uint64_t count);
+void      ag_m_sys_Array_reserve  (AgBaseArray* c, uint64_t items_count);
+void      ag_m_sys_Array_shrinkToFit(AgBaseArray* c);
 AgObject* ag_m_sys_Array_getAt    (AgBaseArray* b, uint64_t index);
 void      ag_m_sys_Array_setAt    (AgBaseArray* b, uint64_t index, AgObject* val);
 AgObject* ag_m_sys_Array_setOptAt (AgBaseArray* b, uint64_t index, AgObject* val);
@@ -26,6 +28,15 @@ bool      ag_m_sys_Array_spliceAt (AgBaseArray* b, uint64_t index, AgObject* val
 // `move` swaps x-y and y-z spans
 bool      ag_m_sys_Array_move     (AgBaseArray* c, uint64_t x, uint64_t y, uint64_t z);
 
+// Sorting and binary search, null items are moved to the end, delegates are called only for not null items
+void      ag_m_sys_Array_sort      (AgBaseArray* c, AgWeak* receiver, AgSortLess less);
+void      ag_m_sys_Array_stableSort(AgBaseArray* c, AgWeak* receiver, AgSortLess less);
+void      ag_m_sys_Array_nthElement(AgBaseArray* c, uint64_t k, AgWeak* receiver, AgSortLess less);
+int64_t   ag_m_sys_Array_partition (AgBaseArray* c, AgWeak* receiver, AgSortPredicate predicate);
+int64_t   ag_m_sys_Array_lowerBound(AgBaseArray* c, AgWeak* receiver, AgSortPredicate is_before);
+void      ag_m_sys_Array_sortByInt (AgBaseArray* c, AgWeak* receiver, AgSortIntKey key);
+void      ag_m_sys_Array_sortByStr (AgBaseArray* c, AgWeak* receiver, AgSortStrKey key);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
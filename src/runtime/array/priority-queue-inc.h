@@ -0,0 +1,208 @@
+// Instantiated in priority-queue.c for every priority type.
+// Expects AG_NAME(PREFIX, SUFFIX), AG_PQ_KEY_T and AG_PQ_LESS(A, B) to be defined.
+
+typedef struct {
+	AG_PQ_KEY_T key;
+	AgObject*   item;  // own
+	uint64_t    slot;
+} AG_NAME(Ag, Entry);
+
+#define AG_PQ_ENTRIES(Q) ((AG_NAME(Ag, Entry)*)(Q)->entries)
+#define AG_PQ_ARITY 4
+
+static inline void AG_NAME(ag_place_, )(AgPriorityQueue* q, uint64_t i, AG_NAME(Ag, Entry) e) {
+	AG_PQ_ENTRIES(q)[i] = e;
+	q->slots[e.slot].pos = (uint32_t)i;
+}
+
+static void AG_NAME(ag_sift_up_, )(AgPriorityQueue* q, uint64_t i) {
+	AG_NAME(Ag, Entry)* entries = AG_PQ_ENTRIES(q);
+	AG_NAME(Ag, Entry) e = entries[i];
+	while (i > 0) {
+		uint64_t parent = (i - 1) / AG_PQ_ARITY;
+		if (!AG_PQ_LESS(e.key, entries[parent].key))
+			break;
+		AG_NAME(ag_place_, )(q, i, entries[parent]);
+		i = parent;
+	}
+	AG_NAME(ag_place_, )(q, i, e);
+}
+
+static void AG_NAME(ag_sift_down_, )(AgPriorityQueue* q, uint64_t i, uint64_t n) {
+	AG_NAME(Ag, Entry)* entries = AG_PQ_ENTRIES(q);
+	AG_NAME(Ag, Entry) e = entries[i];
+	for (;;) {
+		uint64_t first = i * AG_PQ_ARITY + 1;
+		if (first >= n)
+			break;
+		uint64_t last = first + AG_PQ_ARITY < n ? first + AG_PQ_ARITY : n;
+		uint64_t min = first;
+		for (uint64_t c = first + 1; c < last; c++) {
+			if (AG_PQ_LESS(entries[c].key, entries[min].key))
+				min = c;
+		}
+		if (!AG_PQ_LESS(entries[min].key, e.key))
+			break;
+		AG_NAME(ag_place_, )(q, i, entries[min]);
+		i = min;
+	}
+	AG_NAME(ag_place_, )(q, i, e);
+}
+
+void AG_NAME(ag_m_sys_, _heapify)(AgPriorityQueue* q) {
+	if (q->heap_size == q->size)
+		return;
+	if ((q->size - q->heap_size) * 8 < q->size) {
+		while (q->heap_size < q->size)
+			AG_NAME(ag_sift_up_, )(q, q->heap_size++);
+	} else {
+		for (uint64_t i = q->size > 1 ? (q->size - 2) / AG_PQ_ARITY + 1 : 0; i-- > 0;)
+			AG_NAME(ag_sift_down_, )(q, i, q->size);
+		q->heap_size = q->size;
+	}
+}
+
+// Removes entry at `i` from the heap, returns its detached item
+static AgObject* AG_NAME(ag_remove_at_, )(AgPriorityQueue* q, uint64_t i) {
+	AG_NAME(Ag, Entry)* entries = AG_PQ_ENTRIES(q);
+	AG_NAME(Ag, Entry) e = entries[i];
+	ag_free_pq_slot(q, e.slot);
+	uint64_t last = --q->size;
+	q->heap_size = q->size;
+	if (i != last) {
+		AG_NAME(ag_place_, )(q, i, entries[last]);
+		if (i > 0 && AG_PQ_LESS(entries[i].key, entries[(i - 1) / AG_PQ_ARITY].key))
+			AG_NAME(ag_sift_up_, )(q, i);
+		else
+			AG_NAME(ag_sift_down_, )(q, i, q->size);
+	}
+	ag_set_parent(e.item, NULL);
+	return e.item;
+}
+
+bool AG_NAME(ag_m_sys_, _contains)(AgPriorityQueue* q, int64_t handle) {
+	uint64_t slot = (uint32_t)handle;
+	return handle >= 0 &&
+		slot < q->slots_count &&
+		(q->slots[slot].gen & AG_PQ_GEN_MASK) == (uint64_t)handle >> 32 &&
+		q->slots[slot].pos < q->size &&
+		AG_PQ_ENTRIES(q)[q->slots[slot].pos].slot == slot;
+}
+
+int64_t AG_NAME(ag_m_sys_, _append)(AgPriorityQueue* q, AG_PQ_KEY_T priority, AgObject* item) {
+	ag_reserve_pq(q, q->size + 1, sizeof(AG_NAME(Ag, Entry)));
+	ag_retain_own(item, &q->head);
+	AG_NAME(Ag, Entry) e = { priority, item, ag_alloc_pq_slot(q) };
+	AG_NAME(ag_place_, )(q, q->size++, e);
+	return ag_pq_handle(q, e.slot);
+}
+
+int64_t AG_NAME(ag_m_sys_, _push)(AgPriorityQueue* q, AG_PQ_KEY_T priority, AgObject* item) {
+	bool was_heap = q->heap_size == q->size;
+	int64_t r = AG_NAME(ag_m_sys_, _append)(q, priority, item);
+	if (was_heap)
+		AG_NAME(ag_sift_up_, )(q, q->heap_size++);
+	return r;
+}
+
+AgObject* AG_NAME(ag_m_sys_, _peek)(AgPriorityQueue* q) {
+	if (!q->size)
+		return NULL;
+	AG_NAME(ag_m_sys_, _heapify)(q);
+	AgObject* r = AG_PQ_ENTRIES(q)[0].item;
+	ag_retain_pin(r);
+	return r;
+}
+
+AG_PQ_KEY_T AG_NAME(ag_m_sys_, _peekPriority)(AgPriorityQueue* q) {
+	if (!q->size)
+		return 0;
+	AG_NAME(ag_m_sys_, _heapify)(q);
+	return AG_PQ_ENTRIES(q)[0].key;
+}
+
+AgObject* AG_NAME(ag_m_sys_, _pop)(AgPriorityQueue* q) {
+	if (!q->size)
+		return NULL;
+	AG_NAME(ag_m_sys_, _heapify)(q);
+	return AG_NAME(ag_remove_at_, )(q, 0);
+}
+
+bool AG_NAME(ag_m_sys_, _decreaseKey)(AgPriorityQueue* q, int64_t handle, AG_PQ_KEY_T priority) {
+	if (!AG_NAME(ag_m_sys_, _contains)(q, handle))
+		return false;
+	AG_NAME(ag_m_sys_, _heapify)(q);
+	uint64_t i = q->slots[(uint32_t)handle].pos;
+	AG_NAME(Ag, Entry)* e = AG_PQ_ENTRIES(q) + i;
+	if (AG_PQ_LESS(e->key, priority))
+		return false;
+	e->key = priority;
+	AG_NAME(ag_sift_up_, )(q, i);
+	return true;
+}
+
+AgObject* AG_NAME(ag_m_sys_, _remove)(AgPriorityQueue* q, int64_t handle) {
+	if (!AG_NAME(ag_m_sys_, _contains)(q, handle))
+		return NULL;
+	AG_NAME(ag_m_sys_, _heapify)(q);
+	return AG_NAME(ag_remove_at_, )(q, q->slots[(uint32_t)handle].pos);
+}
+
+int64_t AG_NAME(ag_m_sys_, _size)(AgPriorityQueue* q) {
+	return q->size;
+}
+
+void AG_NAME(ag_m_sys_, _reserve)(AgPriorityQueue* q, uint64_t count) {
+	ag_reserve_pq(q, count, sizeof(AG_NAME(Ag, Entry)));
+}
+
+// Keeps slots with bumped generations, so handles of the cleared items never match new ones
+void AG_NAME(ag_m_sys_, _clear)(AgPriorityQueue* q) {
+	AG_NAME(Ag, Entry)* entries = AG_PQ_ENTRIES(q);
+	uint64_t size = q->size;
+	q->size = q->heap_size = 0;
+	for (uint64_t i = 0; i < size; i++) {
+		ag_free_pq_slot(q, entries[i].slot);
+		ag_release_own(entries[i].item);
+	}
+}
+
+void AG_NAME(ag_copy_sys_, )(AgPriorityQueue* d, AgPriorityQueue* s) {
+	d->size = s->size;
+	d->heap_size = s->heap_size;
+	d->slots_count = s->slots_count;
+	d->free_slot = s->free_slot;
+	d->allocated = s->slots_count;  // all slots are kept to keep handles valid
+	d->entries = d->allocated ? ag_alloc(d->allocated * sizeof(AG_NAME(Ag, Entry))) : NULL;
+	d->slots = d->allocated ? ag_alloc(d->allocated * sizeof(AgHeapSlot)) : NULL;
+	if (!d->allocated)
+		return;
+	ag_memcpy(d->entries, s->entries, d->size * sizeof(AG_NAME(Ag, Entry)));
+	ag_memcpy(d->slots, s->slots, d->slots_count * sizeof(AgHeapSlot));
+	AG_NAME(Ag, Entry)* entries = AG_PQ_ENTRIES(d);
+	for (uint64_t i = 0; i < d->size; i++)
+		entries[i].item = ag_copy_object_field(entries[i].item, &d->head);
+}
+
+void AG_NAME(ag_dtor_sys_, )(AgPriorityQueue* q) {
+	AG_NAME(Ag, Entry)* entries = AG_PQ_ENTRIES(q);
+	for (uint64_t i = 0; i < q->size; i++)
+		ag_release_own(entries[i].item);
+	ag_free(q->entries);
+	ag_free(q->slots);
+}
+
+void AG_NAME(ag_visit_sys_, )(
+	AgPriorityQueue* q,
+	void(*visitor)(void*, int, void*),
+	void* ctx)
+{
+	if (ag_not_null(q)) {
+		AG_NAME(Ag, Entry)* entries = AG_PQ_ENTRIES(q);
+		for (uint64_t i = 0; i < q->size; i++)
+			visitor(&entries[i].item, AG_VISIT_OWN, ctx);
+	}
+}
+
+#undef AG_PQ_ENTRIES
+#undef AG_PQ_ARITY
@@ -0,0 +1,49 @@
+#include "array/priority-queue.h"
+
+#define AG_PQ_GEN_MASK 0x7fffffff  // keeps handles positive
+
+static void ag_reserve_pq(AgPriorityQueue* q, uint64_t count, size_t entry_size) {
+	if (count <= q->allocated)
+		return;
+	uint64_t grown = q->allocated + q->allocated / 2 + 8;
+	q->allocated = count > grown ? count : grown;
+	q->entries = ag_realloc(q->entries, q->allocated * entry_size);
+	q->slots = ag_realloc(q->slots, q->allocated * sizeof(AgHeapSlot));
+}
+
+// Slots count never exceeds the max size the queue had, so there is always room in `slots`
+static uint64_t ag_alloc_pq_slot(AgPriorityQueue* q) {
+	if (!q->free_slot) {
+		q->slots[q->slots_count].gen = 0;
+		return q->slots_count++;
+	}
+	uint64_t r = q->free_slot - 1;
+	q->free_slot = q->slots[r].pos;
+	return r;
+}
+
+static void ag_free_pq_slot(AgPriorityQueue* q, uint64_t slot) {
+	q->slots[slot].gen++;
+	q->slots[slot].pos = (uint32_t)q->free_slot;
+	q->free_slot = slot + 1;
+}
+
+static inline int64_t ag_pq_handle(AgPriorityQueue* q, uint64_t slot) {
+	return (int64_t)((uint64_t)(q->slots[slot].gen & AG_PQ_GEN_MASK) << 32 | slot);
+}
+
+#define AG_NAME(PREFIX, SUFFIX) PREFIX##PriorityQueue##SUFFIX
+#define AG_PQ_KEY_T int64_t
+#define AG_PQ_LESS(A, B) ((A) < (B))
+#include "priority-queue-inc.h"
+#undef AG_NAME
+#undef AG_PQ_KEY_T
+#undef AG_PQ_LESS
+
+#define AG_NAME(PREFIX, SUFFIX) PREFIX##DoublePriorityQueue##SUFFIX
+#define AG_PQ_KEY_T double
+#define AG_PQ_LESS(A, B) ((A) < (B) || ((B) != (B) && (A) == (A)))  // NaNs go last
+#include "priority-queue-inc.h"
+#undef AG_NAME
+#undef AG_PQ_KEY_T
+#undef AG_PQ_LESS
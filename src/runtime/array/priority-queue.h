@@ -0,0 +1,59 @@
+#ifndef AG_PRIORITY_QUEUE_H_
+#define AG_PRIORITY_QUEUE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "runtime.h"
+
+// PriorityQueue and DoublePriorityQueue: 4-ary min-heaps of owned objects with inline int64 or double priorities.
+// Every pushed item gets a handle that stays valid till the item leaves the queue.
+// Handles of removed items are detected by a generation counter in the upper 32 bits.
+// `clear` keeps the slots and bumps their generations, so old handles stay detectable after it.
+// `append` adds items without restoring the heap order, it gets restored in O(n) by the first ordered access.
+
+typedef struct {
+	uint32_t gen;
+	uint32_t pos;  // index in entries for used slots, 1-based index of the next free slot or 0 for free ones
+} AgHeapSlot;
+
+typedef struct {
+	AgObject    head;
+	void*       entries;      // key, item, slot index
+	AgHeapSlot* slots;
+	uint64_t    size;
+	uint64_t    allocated;    // entries and slots
+	uint64_t    slots_count;  // used and free
+	uint64_t    free_slot;    // 1-based, 0 - none
+	uint64_t    heap_size;    // entries[0..heap_size) are in heap order
+} AgPriorityQueue;
+
+#define AG_PRIORITY_QUEUE_DECLS(NAME, KEY_T)                                                                  \
+	void      ag_copy_sys_##NAME             (AgPriorityQueue* dst, AgPriorityQueue* src);                   \
+	void      ag_dtor_sys_##NAME             (AgPriorityQueue* q);                                          \
+	void      ag_visit_sys_##NAME            (AgPriorityQueue* q, void(*visitor)(void*, int, void*), void* ctx); \
+	int64_t   ag_m_sys_##NAME##_size         (AgPriorityQueue* q);                                          \
+	void      ag_m_sys_##NAME##_clear        (AgPriorityQueue* q);                                          \
+	void      ag_m_sys_##NAME##_reserve      (AgPriorityQueue* q, uint64_t count);                          \
+	int64_t   ag_m_sys_##NAME##_push         (AgPriorityQueue* q, KEY_T priority, AgObject* item); /* returns handle */ \
+	int64_t   ag_m_sys_##NAME##_append       (AgPriorityQueue* q, KEY_T priority, AgObject* item); /* returns handle */ \
+	void      ag_m_sys_##NAME##_heapify      (AgPriorityQueue* q);                                          \
+	AgObject* ag_m_sys_##NAME##_peek         (AgPriorityQueue* q);  /* returns ?T */                         \
+	KEY_T     ag_m_sys_##NAME##_peekPriority (AgPriorityQueue* q);  /* returns 0 if empty */                 \
+	AgObject* ag_m_sys_##NAME##_pop          (AgPriorityQueue* q);  /* returns detached ?T */                \
+	bool      ag_m_sys_##NAME##_contains     (AgPriorityQueue* q, int64_t handle);                          \
+	bool      ag_m_sys_##NAME##_decreaseKey  (AgPriorityQueue* q, int64_t handle, KEY_T priority);          \
+	AgObject* ag_m_sys_##NAME##_remove       (AgPriorityQueue* q, int64_t handle);  /* returns detached ?T */
+
+AG_PRIORITY_QUEUE_DECLS(PriorityQueue, int64_t)
+AG_PRIORITY_QUEUE_DECLS(DoublePriorityQueue, double)
+
+#undef AG_PRIORITY_QUEUE_DECLS
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // AG_PRIORITY_QUEUE_H_
@@ -16,10 +16,21 @@ void      ag_visit_sys_SharedArray      (AgBaseArray* ptr, void(*visitor)(void*,
 int64_t   ag_m_sys_SharedArray_capacity (AgBaseArray* c);
 void      ag_m_sys_SharedArray_insert   (AgBaseArray* c, uint64_t at, uint64_t items_count);
 void      ag_m_sys_SharedArray_delete   (AgBaseArray* b, uint64_t index, uint64_t count);
+void      ag_m_sys_SharedArray_reserve  (AgBaseArray* c, uint64_t items_count);
+void      ag_m_sys_SharedArray_shrinkToFit(AgBaseArray* c);
 bool      ag_m_sys_SharedArray_move     (AgBaseArray* c, uint64_t x, uint64_t y, uint64_t z);
 AgObject* ag_m_sys_SharedArray_getAt    (AgBaseArray* b, uint64_t index);
 void      ag_m_sys_SharedArray_setAt    (AgBaseArray* b, uint64_t index, AgObject* val);
 
+// Sorting and binary search, null items are moved to the end, delegates are called only for not null items
+void      ag_m_sys_SharedArray_sort      (AgBaseArray* c, AgWeak* receiver, AgSortLess less);
+void      ag_m_sys_SharedArray_stableSort(AgBaseArray* c, AgWeak* receiver, AgSortLess less);
+void      ag_m_sys_SharedArray_nthElement(AgBaseArray* c, uint64_t k, AgWeak* receiver, AgSortLess less);
+int64_t   ag_m_sys_SharedArray_partition (AgBaseArray* c, AgWeak* receiver, AgSortPredicate predicate);
+int64_t   ag_m_sys_SharedArray_lowerBound(AgBaseArray* c, AgWeak* receiver, AgSortPredicate is_before);
+void      ag_m_sys_SharedArray_sortByInt (AgBaseArray* c, AgWeak* receiver, AgSortIntKey key);
+void      ag_m_sys_SharedArray_sortByStr (AgBaseArray* c, AgWeak* receiver, AgSortStrKey key);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -0,0 +1,71 @@
+// Instantiated in typed-array.c for every item type.
+// Expects AG_NAME(PREFIX, SUFFIX) and AG_ITEM_TYPE to be defined.
+
+int64_t AG_NAME(ag_m_sys_, _capacity)(AgTypedArray* c) {
+	return c->items_count;
+}
+
+void AG_NAME(ag_m_sys_, _insert)(AgTypedArray* c, uint64_t at, uint64_t count) {
+	ag_insert_items(c, at, count, sizeof(AG_ITEM_TYPE));
+}
+
+void AG_NAME(ag_m_sys_, _delete)(AgTypedArray* c, uint64_t at, uint64_t count) {
+	if (count && at <= c->items_count && count <= c->items_count - at)
+		ag_delete_items(c, at, count, sizeof(AG_ITEM_TYPE));
+}
+
+void AG_NAME(ag_m_sys_, _reserve)(AgTypedArray* c, uint64_t count) {
+	ag_reserve_items(c, count, sizeof(AG_ITEM_TYPE));
+}
+
+void AG_NAME(ag_m_sys_, _shrinkToFit)(AgTypedArray* c) {
+	ag_shrink_items(c, sizeof(AG_ITEM_TYPE));
+}
+
+AG_ITEM_TYPE AG_NAME(ag_m_sys_, _getAt)(AgTypedArray* c, uint64_t index) {
+	return index < c->items_count
+		? ((AG_ITEM_TYPE*)c->items)[index]
+		: 0;
+}
+
+void AG_NAME(ag_m_sys_, _setAt)(AgTypedArray* c, uint64_t index, AG_ITEM_TYPE val) {
+	if (index < c->items_count)
+		((AG_ITEM_TYPE*)c->items)[index] = val;
+}
+
+bool AG_NAME(ag_m_sys_, _fill)(AgTypedArray* c, uint64_t at, uint64_t count, AG_ITEM_TYPE val) {
+	if (at > c->items_count || count > c->items_count - at)
+		return false;
+	AG_ITEM_TYPE* i = (AG_ITEM_TYPE*)c->items + at;
+	for (AG_ITEM_TYPE* term = i + count; i < term; i++)
+		*i = val;
+	return true;
+}
+
+bool AG_NAME(ag_m_sys_, _copy)(AgTypedArray* dst, uint64_t dst_at, AgTypedArray* src, uint64_t src_at, uint64_t count) {
+	if (src_at > src->items_count || count > src->items_count - src_at ||
+		dst_at > dst->items_count || count > dst->items_count - dst_at)
+		return false;
+	ag_memmove(
+		(AG_ITEM_TYPE*)dst->items + dst_at,
+		(AG_ITEM_TYPE*)src->items + src_at,
+		count * sizeof(AG_ITEM_TYPE));
+	return true;
+}
+
+void AG_NAME(ag_copy_sys_, )(AgTypedArray* d, AgTypedArray* s) {
+	d->items_count = d->items_allocated = s->items_count;
+	d->items = d->items_count ? ag_alloc(s->items_count * sizeof(AG_ITEM_TYPE)) : NULL;
+	if (d->items)
+		ag_memcpy(d->items, s->items, s->items_count * sizeof(AG_ITEM_TYPE));
+}
+
+void AG_NAME(ag_dtor_sys_, )(AgTypedArray* c) {
+	ag_free(c->items);
+}
+
+void AG_NAME(ag_visit_sys_, )(
+	AgTypedArray* c,
+	void(*visitor)(void*, int, void*),
+	void* ctx)
+{}
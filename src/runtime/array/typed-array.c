@@ -0,0 +1,25 @@
+#include "array/typed-array.h"
+
+#define AG_NAME(PREFIX, SUFFIX) PREFIX##Int32Array##SUFFIX
+#define AG_ITEM_TYPE int32_t
+#include "typed-array-inc.h"
+#undef AG_NAME
+#undef AG_ITEM_TYPE
+
+#define AG_NAME(PREFIX, SUFFIX) PREFIX##Int64Array##SUFFIX
+#define AG_ITEM_TYPE int64_t
+#include "typed-array-inc.h"
+#undef AG_NAME
+#undef AG_ITEM_TYPE
+
+#define AG_NAME(PREFIX, SUFFIX) PREFIX##FloatArray##SUFFIX
+#define AG_ITEM_TYPE float
+#include "typed-array-inc.h"
+#undef AG_NAME
+#undef AG_ITEM_TYPE
+
+#define AG_NAME(PREFIX, SUFFIX) PREFIX##DoubleArray##SUFFIX
+#define AG_ITEM_TYPE double
+#include "typed-array-inc.h"
+#undef AG_NAME
+#undef AG_ITEM_TYPE
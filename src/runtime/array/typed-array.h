@@ -0,0 +1,46 @@
+#ifndef AG_TYPED_ARRAY_H_
+#define AG_TYPED_ARRAY_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "array/array-base.h"
+
+// Common layout of Int32Array, Int64Array, FloatArray and DoubleArray.
+// It is the AgBaseArray layout, but items are stored unboxed and contiguously,
+// so compiler inlines getAt/setAt as plain loads/stores.
+// Sorting and binary search use natural order with NaNs placed last.
+typedef AgBaseArray AgTypedArray;
+
+#define AG_TYPED_ARRAY_DECLS(NAME, ITEM_TYPE)                                                                          \
+	void    ag_copy_sys_##NAME          (AgTypedArray* dst, AgTypedArray* src);                                     \
+	void    ag_dtor_sys_##NAME          (AgTypedArray* ptr);                                                        \
+	void    ag_visit_sys_##NAME         (AgTypedArray* ptr, void(*visitor)(void*, int, void*), void* ctx);          \
+	int64_t ag_m_sys_##NAME##_capacity  (AgTypedArray* c);                                                          \
+	void    ag_m_sys_##NAME##_insert    (AgTypedArray* c, uint64_t at, uint64_t count);                             \
+	void    ag_m_sys_##NAME##_delete    (AgTypedArray* c, uint64_t at, uint64_t count);                             \
+	void    ag_m_sys_##NAME##_reserve   (AgTypedArray* c, uint64_t count);                                          \
+	void    ag_m_sys_##NAME##_shrinkToFit(AgTypedArray* c);                                                         \
+	ITEM_TYPE ag_m_sys_##NAME##_getAt   (AgTypedArray* c, uint64_t index);                                          \
+	void    ag_m_sys_##NAME##_setAt     (AgTypedArray* c, uint64_t index, ITEM_TYPE val);                           \
+	bool    ag_m_sys_##NAME##_fill      (AgTypedArray* c, uint64_t at, uint64_t count, ITEM_TYPE val);              \
+	bool    ag_m_sys_##NAME##_copy      (AgTypedArray* dst, uint64_t dst_at, AgTypedArray* src, uint64_t src_at, uint64_t count); \
+	void    ag_m_sys_##NAME##_sort      (AgTypedArray* c);                                                          \
+	void    ag_m_sys_##NAME##_nthElement(AgTypedArray* c, uint64_t k);                                              \
+	int64_t ag_m_sys_##NAME##_lowerBound(AgTypedArray* c, ITEM_TYPE val);                                           \
+	int64_t ag_m_sys_##NAME##_upperBound(AgTypedArray* c, ITEM_TYPE val);
+
+AG_TYPED_ARRAY_DECLS(Int32Array, int32_t)
+AG_TYPED_ARRAY_DECLS(Int64Array, int64_t)
+AG_TYPED_ARRAY_DECLS(FloatArray, float)
+AG_TYPED_ARRAY_DECLS(DoubleArray, double)
+
+#undef AG_TYPED_ARRAY_DECLS
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // AG_TYPED_ARRAY_H_
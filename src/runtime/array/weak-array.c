@@ -10,3 +10,6 @@
 #define AG_ITEM_TYPE AgWeak*
 
 #include "array-base-inc.h"
+
+#define AG_DETACH(PTR) (void)(PTR)
+#include "deque-inc.h"
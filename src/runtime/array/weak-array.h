@@ -16,6 +16,8 @@ void    ag_visit_sys_WeakArray (AgBaseArray* ptr, void(*visitor)(void*, int, voi
 int64_t ag_m_sys_WeakArray_capacity (AgBaseArray* c);
 void    ag_m_sys_WeakArray_insert   (AgBaseArray* c, uint64_t at, uint64_t items_count);
 void    ag_m_sys_WeakArray_delete   (AgBaseArray* b, uint64_t index, uint64_t count);
+void    ag_m_sys_WeakArray_reserve  (AgBaseArray* c, uint64_t items_count);
+void    ag_m_sys_WeakArray_shrinkToFit(AgBaseArray* c);
 bool    ag_m_sys_WeakArray_move     (AgBaseArray* c, uint64_t x, uint64_t y, uint64_t z);
 AgWeak* ag_m_sys_WeakArray_getAt    (AgBaseArray* b, uint64_t index);
 void    ag_m_sys_WeakArray_setAt    (AgBaseArray* b, uint64_t index, AgWeak* val);
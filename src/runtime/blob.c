@@ -1,30 +1,41 @@
 #include "blob.h"
 #include "utf8.h"
+#include "number.h"
+#include "json-scan.h"
 
 int64_t ag_m_sys_Blob_capacity(AgBlob* b) {
 	return b->bytes_count;
 }
 
+void ag_m_sys_Blob_reserve(AgBlob* b, uint64_t bytes_count) {
+	if (bytes_count <= b->bytes_allocated)
+		return;
+	b->bytes = (int8_t*) ag_realloc(b->bytes, bytes_count);
+	b->bytes_allocated = bytes_count;
+}
+
+void ag_m_sys_Blob_truncate(AgBlob* b, uint64_t bytes_count) {
+	if (bytes_count < b->bytes_count)
+		b->bytes_count = bytes_count;
+}
+
 void ag_m_sys_Blob_insert(AgBlob* b, uint64_t index, uint64_t count) {
 	if (!count || index > b->bytes_count)
 		return;
-	int8_t* new_data = (int8_t*) ag_alloc(b->bytes_count + count);
-	ag_memcpy(new_data, b->bytes, index);
-	ag_zero_mem(new_data + index, count);
-	ag_memcpy(new_data + index + count, b->bytes + index, b->bytes_count - index);
-	ag_free(b->bytes);
-	b->bytes = new_data;
-	b->bytes_count += count;
+	uint64_t new_count = b->bytes_count + count;
+	if (new_count > b->bytes_allocated) {
+		uint64_t grown = b->bytes_allocated + b->bytes_allocated / 2 + 16;
+		ag_m_sys_Blob_reserve(b, new_count > grown ? new_count : grown);
+	}
+	ag_memmove(b->bytes + index + count, b->bytes + index, b->bytes_count - index);
+	ag_zero_mem(b->bytes + index, count);
+	b->bytes_count = new_count;
 }
 
 void ag_m_sys_Blob_delete(AgBlob* b, uint64_t index, uint64_t count) {
 	if (!count || index > b->bytes_count || index + count > b->bytes_count)
 		return;
-	int8_t* new_data = (int8_t*) ag_alloc(b->bytes_count - count);
-	ag_memcpy(new_data, b->bytes, index);
-	ag_memcpy(new_data + index, b->bytes + index + count, b->bytes_count - index - count);
-	ag_free(b->bytes);
-	b->bytes = new_data;
+	ag_memmove(b->bytes + index, b->bytes + index + count, b->bytes_count - index - count);
 	b->bytes_count -= count;
 }
 
@@ -80,7 +91,7 @@ bool ag_m_sys_Blob_copy(AgBlob* dst, uint64_t dst_index, AgBlob* src, uint64_t s
 }
 
 void ag_copy_sys_Blob(AgBlob* d, AgBlob* s) {
-	d->bytes_count = s->bytes_count;
+	d->bytes_count = d->bytes_allocated = s->bytes_count;
 	d->bytes = ag_alloc(d->bytes_count);
 	ag_memcpy(d->bytes, s->bytes, d->bytes_count);
 }
@@ -111,9 +122,131 @@ int64_t ag_m_sys_Blob_putChAt(AgBlob* b, uint64_t at, uint32_t codepoint) {
 }
 
 AgString* ag_m_sys_Blob_mkStr(AgBlob* b, uint64_t at, uint64_t count) {
-	if (count < 0 || at + count > b->bytes_count)
-		count = 0;
-	return ag_make_str(b->bytes + at, count);
+	if (at > b->bytes_count || count > b->bytes_count - at)
+		return ag_make_str("", 0);
+	return ag_make_str((const char*)b->bytes + at, count);
+}
+
+AgString* ag_m_sys_Blob_mkInternedStr(AgBlob* b, uint64_t at, uint64_t count) {
+	if (at > b->bytes_count || count > b->bytes_count - at)
+		return ag_make_interned_str("", 0);
+	return ag_make_interned_str((const char*)b->bytes + at, count);
+}
+
+// Makes the blob hold at least `at + count` bytes, grows it geometrically, returns the write position
+static int8_t* ag_blob_room(AgBlob* b, uint64_t at, uint64_t count) {
+	uint64_t size = at + count;
+	if (size > b->bytes_count) {
+		uint64_t grown = b->bytes_count * 2 + 16;
+		ag_make_blob_fit(b, size > grown ? size : grown);
+	}
+	return b->bytes + at;
+}
+
+static int64_t ag_blob_put(AgBlob* b, uint64_t at, const void* src, uint64_t count) {
+	ag_memcpy(ag_blob_room(b, at, count), src, count);
+	return at + count;
+}
+
+int64_t ag_m_sys_Blob_putStrAt(AgBlob* b, uint64_t at, AgString* s) {
+	return ag_blob_put(b, at, s->chars, s->size);
+}
+
+int64_t ag_m_sys_Blob_putSubstrAt(AgBlob* b, uint64_t at, AgString* s, uint64_t from, uint64_t to) {
+	if (to > s->size)
+		to = s->size;
+	return from < to
+		? ag_blob_put(b, at, s->chars + from, to - from)
+		: (int64_t)at;
+}
+
+int64_t ag_m_sys_Blob_putSliceAt(AgBlob* b, uint64_t at, AgStringSlice* s) {
+	return s->str
+		? ag_m_sys_Blob_putSubstrAt(b, at, s->str, s->start, s->end)
+		: (int64_t)at;
+}
+
+int64_t ag_m_sys_Blob_putBlobAt(AgBlob* b, uint64_t at, AgBlob* src, uint64_t from, uint64_t count) {
+	if (from >= src->bytes_count)
+		return at;
+	if (count > src->bytes_count - from)
+		count = src->bytes_count - from;
+	int8_t* dst = ag_blob_room(b, at, count);  // can reallocate `src` if it is `b`
+	ag_memmove(dst, src->bytes + from, count);
+	return at + count;
+}
+
+int64_t ag_m_sys_Blob_putRepeatAt(AgBlob* b, uint64_t at, uint32_t codepoint, uint64_t count) {
+	int8_t ch[8];
+	int8_t* ch_end = ch;
+	put_utf8(codepoint, &ch_end, ag_put_fn);
+	uint64_t ch_size = ch_end - ch;
+	if (!count || !ch_size)
+		return at;
+	uint64_t size = ch_size * count;
+	int8_t* dst = ag_blob_room(b, at, size);
+	ag_memcpy(dst, ch, ch_size);
+	for (uint64_t filled = ch_size; filled < size; filled *= 2)  // doubles the repeated part
+		ag_memcpy(dst + filled, dst, filled < size - filled ? filled : size - filled);
+	return at + size;
+}
+
+int64_t ag_m_sys_Blob_putJoinedAt(AgBlob* b, uint64_t at, AgBaseArray* items, AgString* separator) {
+	if (!items->items_count)
+		return at;
+	AgString** strs = (AgString**)items->items;
+	uint64_t size = separator->size * (items->items_count - 1);
+	for (uint64_t i = 0; i < items->items_count; i++) {
+		if (strs[i])
+			size += strs[i]->size;
+	}
+	int8_t* dst = ag_blob_room(b, at, size);
+	for (uint64_t i = 0; i < items->items_count; i++) {
+		if (i) {
+			ag_memcpy(dst, separator->chars, separator->size);
+			dst += separator->size;
+		}
+		if (strs[i]) {
+			ag_memcpy(dst, strs[i]->chars, strs[i]->size);
+			dst += strs[i]->size;
+		}
+	}
+	return at + size;
+}
+
+int64_t ag_m_sys_Blob_putIntAt(AgBlob* b, uint64_t at, int64_t v) {
+	return at + ag_format_int(v, (char*)ag_blob_room(b, at, AG_INT_TEXT_MAX));
+}
+
+int64_t ag_m_sys_Blob_putDoubleAt(AgBlob* b, uint64_t at, double v) {
+	return at + ag_format_double(v, (char*)ag_blob_room(b, at, AG_DOUBLE_TEXT_MAX));
+}
+
+int64_t ag_m_sys_Blob_putJsonStrAt(AgBlob* b, uint64_t at, AgCursor* src, int64_t max_runes) {
+	const char* start = src->pos;
+	if (!start || start >= src->end)
+		return -AG_JSON_INCOMPLETE_STRING;
+	const char* after = start;
+	int r = ag_json_skip_str(&after, src->end);
+	src->pos = after;
+	if (r != AG_JSON_OK)
+		return -r;
+	size_t size;
+	const char* close = after - 1;
+	r = ag_json_unescape(start, close, (char*)ag_blob_room(b, at, close - start), max_runes, &size);
+	return r == AG_JSON_OK ? (int64_t)(at + size) : -r;
+}
+
+int64_t ag_m_sys_Blob_putJsonQuotedAt(AgBlob* b, uint64_t at, AgString* s) {
+	size_t size = ag_json_escaped_size(s->chars, s->size);
+	char* dst = (char*)ag_blob_room(b, at, size + 2);
+	dst[0] = '"';
+	if (size == s->size)
+		ag_memcpy(dst + 1, s->chars, size);
+	else
+		ag_json_escape(s->chars, s->size, dst + 1);
+	dst[size + 1] = '"';
+	return (int64_t)(at + size + 2);
 }
 
 void ag_make_blob_fit(AgBlob* b, size_t size) {
@@ -1,16 +1,18 @@
 #ifndef AG_BLOB_H_
 #define AG_BLOB_H_
 
-#include "runtime.h"
-
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#include "runtime.h"
+#include "array/array-base.h"
+
 typedef struct {
 	AgObject head;
 	uint64_t bytes_count;
 	int8_t* bytes;
+	uint64_t bytes_allocated;  // >= bytes_count, grows geometrically
 } AgBlob;
 
 void    ag_copy_sys_Blob         (AgBlob* dst, AgBlob* src);
@@ -20,6 +22,8 @@ void    ag_visit_sys_Blob        (void* ptr, void(*visitor)(void*, int, void*),
 int64_t   ag_m_sys_Blob_capacity   (AgBlob* b);
 void      ag_m_sys_Blob_insert     (AgBlob* b, uint64_t index, uint64_t bytes_count);
 void      ag_m_sys_Blob_delete     (AgBlob* b, uint64_t index, uint64_t count);
+void      ag_m_sys_Blob_reserve    (AgBlob* b, uint64_t bytes_count);
+void      ag_m_sys_Blob_truncate   (AgBlob* b, uint64_t bytes_count);
 bool      ag_m_sys_Blob_copy       (AgBlob* dst, uint64_t dst_index, AgBlob* src, uint64_t src_index, uint64_t bytes);
 int32_t   ag_m_sys_Blob_get8At     (AgBlob* b, uint64_t index);
 void      ag_m_sys_Blob_set8At     (AgBlob* b, uint64_t index, int32_t val);
@@ -30,8 +34,24 @@ void      ag_m_sys_Blob_set32At    (AgBlob* b, uint64_t index, int32_t val);
 int64_t   ag_m_sys_Blob_get64At    (AgBlob* b, uint64_t index);
 void      ag_m_sys_Blob_set64At    (AgBlob* b, uint64_t index, int64_t val);
 AgString* ag_m_sys_Blob_mkStr      (AgBlob* b, uint64_t at, uint64_t count);
+AgString* ag_m_sys_Blob_mkInternedStr(AgBlob* b, uint64_t at, uint64_t count);
 int64_t   ag_m_sys_Blob_putChAt    (AgBlob* b, uint64_t at, uint32_t codepoint);
 
+// Bulk appends, these grow blob geometrically and return the position after the written bytes
+int64_t   ag_m_sys_Blob_putStrAt   (AgBlob* b, uint64_t at, AgString* s);
+int64_t   ag_m_sys_Blob_putSubstrAt(AgBlob* b, uint64_t at, AgString* s, uint64_t from, uint64_t to);  // byte offsets
+int64_t   ag_m_sys_Blob_putSliceAt (AgBlob* b, uint64_t at, AgStringSlice* s);
+int64_t   ag_m_sys_Blob_putBlobAt  (AgBlob* b, uint64_t at, AgBlob* src, uint64_t from, uint64_t count);
+int64_t   ag_m_sys_Blob_putRepeatAt(AgBlob* b, uint64_t at, uint32_t codepoint, uint64_t count);
+int64_t   ag_m_sys_Blob_putIntAt   (AgBlob* b, uint64_t at, int64_t v);
+int64_t   ag_m_sys_Blob_putDoubleAt(AgBlob* b, uint64_t at, double v);  // shortest text that reads back to `v`
+// Unescapes a JSON string at the `src` cursor positioned past the opening quote, moves cursor past the closing one.
+// Returns the position after the written bytes or a negative AG_JSON_* error code.
+int64_t   ag_m_sys_Blob_putJsonStrAt(AgBlob* b, uint64_t at, AgCursor* src, int64_t max_runes);
+// Writes `s` as a quoted JSON string with escapes, returns the position after the closing quote.
+int64_t   ag_m_sys_Blob_putJsonQuotedAt(AgBlob* b, uint64_t at, AgString* s);
+int64_t   ag_m_sys_Blob_putJoinedAt(AgBlob* b, uint64_t at, AgBaseArray* items, AgString* separator);  // SharedArray(String)
+
 void    ag_make_blob_fit          (AgBlob* b, size_t size);
 
 #ifdef __cplusplus
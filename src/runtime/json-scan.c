@@ -0,0 +1,250 @@
+#include <string.h>  // memcpy
+#include "json-scan.h"
+#include "runtime.h"
+#include "utf8.h"
+
+#define AG_JSON_ONES  0x0101010101010101ull
+#define AG_JSON_HIGHS 0x8080808080808080ull
+
+static uint64_t ag_json_load8(const char* p) {
+	uint64_t r;
+	memcpy(&r, p, sizeof(r));
+	return r;
+}
+
+// Nonzero if any byte of `w` is zero
+static uint64_t ag_json_has_zero(uint64_t w) {
+	return (w - AG_JSON_ONES) & ~w & AG_JSON_HIGHS;
+}
+
+// Nonzero if any of 8 bytes at `p` is a quote or a backslash
+static uint64_t ag_json_str_special(const char* p) {
+	uint64_t w = ag_json_load8(p);
+	return ag_json_has_zero(w ^ (AG_JSON_ONES * '"')) | ag_json_has_zero(w ^ (AG_JSON_ONES * '\\'));
+}
+
+// Nonzero if any of 8 bytes at `p` must be escaped in a JSON string: a quote, a backslash or a control char
+static uint64_t ag_json_needs_escape(const char* p) {
+	uint64_t w = ag_json_load8(p);
+	return ag_json_has_zero(w ^ (AG_JSON_ONES * '"')) |
+		ag_json_has_zero(w ^ (AG_JSON_ONES * '\\')) |
+		((w - AG_JSON_ONES * 0x20) & ~w & AG_JSON_HIGHS);
+}
+
+// Nonzero if any of 8 bytes at `p` is a quote or a bracket
+static uint64_t ag_json_structural(const char* p) {
+	uint64_t w = ag_json_load8(p);
+	uint64_t lower = w | (AG_JSON_ONES * 0x20);  // maps [] to {}
+	return ag_json_has_zero(w ^ (AG_JSON_ONES * '"')) |
+		ag_json_has_zero(lower ^ (AG_JSON_ONES * '{')) |
+		ag_json_has_zero(lower ^ (AG_JSON_ONES * '}'));
+}
+
+int ag_json_skip_str(const char** pos, const char* end) {
+	const char* p = *pos;
+	for (;;) {
+		while (end - p >= 8 && !ag_json_str_special(p))
+			p += 8;
+		if (p >= end) {
+			*pos = end;
+			return AG_JSON_INCOMPLETE_STRING;
+		}
+		char c = *p++;
+		if (c == '"') {
+			*pos = p;
+			return AG_JSON_OK;
+		}
+		if (c == '\\' && p++ >= end) {
+			*pos = end;
+			return AG_JSON_INCOMPLETE_ESCAPE;
+		}
+	}
+}
+
+int ag_json_skip_nested(const char** pos, const char* end, char open) {
+	char local_stack[256];
+	char* stack = local_stack;
+	size_t capacity = sizeof(local_stack);
+	size_t depth = 0;
+	stack[depth++] = open == '{' ? '}' : ']';
+	const char* p = *pos;
+	int r = AG_JSON_OK;
+	while (depth) {
+		while (end - p >= 8 && !ag_json_structural(p))
+			p += 8;
+		if (p >= end) {
+			r = stack[depth - 1] == '}' ? AG_JSON_INCOMPLETE_OBJECT : AG_JSON_INCOMPLETE_ARRAY;
+			p = end;
+			break;
+		}
+		char c = *p++;
+		if (c == '"') {
+			if ((r = ag_json_skip_str(&p, end)) != AG_JSON_OK)
+				break;
+		} else if (c == '{' || c == '[') {
+			if (depth == capacity) {
+				char* grown = ag_alloc(capacity * 2);
+				memcpy(grown, stack, depth);
+				if (stack != local_stack)
+					ag_free(stack);
+				stack = grown;
+				capacity *= 2;
+			}
+			stack[depth++] = c == '{' ? '}' : ']';
+		} else if (c == '}' || c == ']') {
+			if (stack[--depth] != c) {
+				r = AG_JSON_MISMATCHED;
+				p--;
+				break;
+			}
+		}
+	}
+	if (stack != local_stack)
+		ag_free(stack);
+	*pos = p;
+	return r;
+}
+
+static int ag_json_hex4(const char** pos, const char* end, int* r) {
+	const char* p = *pos;
+	if (end - p < 4)
+		return AG_JSON_BAD_HEX;
+	int v = 0;
+	for (int i = 0; i < 4; i++, p++) {
+		char c = *p;
+		v <<= 4;
+		if (c >= '0' && c <= '9') v |= c - '0';
+		else if (c >= 'a' && c <= 'f') v |= c - 'a' + 10;
+		else if (c >= 'A' && c <= 'F') v |= c - 'A' + 10;
+		else return AG_JSON_BAD_HEX;
+	}
+	*pos = p;
+	*r = v;
+	return AG_JSON_OK;
+}
+
+static int ag_json_put(void* ctx, int c) {
+	*(*(char**)ctx)++ = (char)c;
+	return 1;
+}
+
+int ag_json_unescape(const char* pos, const char* close, char* dst, int64_t max_runes, size_t* dst_size) {
+	const char* p = pos;
+	char* d = dst;
+	int r = AG_JSON_OK;
+	for (int64_t runes = 0; p < close && (max_runes <= 0 || runes < max_runes); runes++) {
+		if (max_runes <= 0) {
+			// Copies runs of plain bytes at once
+			const char* run = p;
+			while (close - p >= 8 && !ag_json_str_special(p))
+				p += 8;
+			while (p < close && *p != '\\')
+				p++;
+			memcpy(d, run, p - run);
+			d += p - run;
+			if (p == close)
+				break;
+		}
+		char c = *p++;
+		if (c != '\\') {
+			*d++ = c;
+			while (max_runes > 0 && p < close && (*p & 0xc0) == 0x80)  // rest of the multibyte char
+				*d++ = *p++;
+			continue;
+		}
+		if (p == close) {
+			r = AG_JSON_INCOMPLETE_ESCAPE;
+			break;
+		}
+		switch (c = *p++) {
+		case '"': case '\\': case '/': *d++ = c; break;
+		case 'b': *d++ = '\b'; break;
+		case 'f': *d++ = '\f'; break;
+		case 'n': *d++ = '\n'; break;
+		case 'r': *d++ = '\r'; break;
+		case 't': *d++ = '\t'; break;
+		case 'u': {
+			int v;
+			if ((r = ag_json_hex4(&p, close, &v)) != AG_JSON_OK)
+				goto done;
+			if (v >= 0xdc00 && v <= 0xdfff) {
+				r = AG_JSON_BAD_SURROGATE;
+				goto done;
+			}
+			if (v >= 0xd800 && v <= 0xdbff) {
+				int low;
+				if (close - p < 2 || p[0] != '\\' || p[1] != 'u') {
+					r = AG_JSON_BAD_SURROGATE;
+					goto done;
+				}
+				p += 2;
+				if ((r = ag_json_hex4(&p, close, &low)) != AG_JSON_OK)
+					goto done;
+				if (low < 0xdc00 || low > 0xdfff) {
+					r = AG_JSON_BAD_SURROGATE;
+					goto done;
+				}
+				v = ((v & 0x3ff) << 10 | (low & 0x3ff)) + 0x10000;
+			}
+			put_utf8(v, &d, ag_json_put);
+			break;
+		}
+		default:
+			r = AG_JSON_BAD_ESCAPE;
+			goto done;
+		}
+	}
+done:
+	*dst_size = d - dst;
+	return r;
+}
+
+// Escape sequence tails for control chars, 'u' for the ones having no short form
+static const char ag_json_short_escapes[32] = {
+	'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't', 'n', 'u', 'f', 'r', 'u', 'u',
+	'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u' };
+
+size_t ag_json_escaped_size(const char* src, size_t size) {
+	const char* p = src;
+	const char* end = src + size;
+	size_t r = size;
+	for (;;) {
+		while (end - p >= 8 && !ag_json_needs_escape(p))
+			p += 8;
+		if (p >= end)
+			return r;
+		unsigned char c = *p++;
+		if (c == '"' || c == '\\')
+			r++;
+		else if (c < 0x20)
+			r += ag_json_short_escapes[c] == 'u' ? 5 : 1;
+	}
+}
+
+size_t ag_json_escape(const char* src, size_t size, char* dst) {
+	static const char hex[] = "0123456789abcdef";
+	const char* p = src;
+	const char* end = src + size;
+	char* d = dst;
+	for (;;) {
+		const char* run = p;
+		while (end - p >= 8 && !ag_json_needs_escape(p))
+			p += 8;
+		while (p < end && (unsigned char)*p >= 0x20 && *p != '"' && *p != '\\')
+			p++;
+		memcpy(d, run, p - run);
+		d += p - run;
+		if (p == end)
+			return d - dst;
+		unsigned char c = *p++;
+		*d++ = '\\';
+		if (c >= 0x20) {
+			*d++ = c;
+		} else if ((*d++ = ag_json_short_escapes[c]) == 'u') {
+			*d++ = '0';
+			*d++ = '0';
+			*d++ = hex[c >> 4];
+			*d++ = hex[c & 0xf];
+		}
+	}
+}
@@ -0,0 +1,46 @@
+#ifndef AG_JSON_SCAN_H_
+#define AG_JSON_SCAN_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// JSON scanners used by json.Parser, they skip 8 bytes at a time over the text without structural chars.
+// All of them return AG_JSON_OK or an error code and move `*pos` past the scanned part or to the error position.
+
+#define AG_JSON_OK                0
+#define AG_JSON_INCOMPLETE_STRING 1
+#define AG_JSON_INCOMPLETE_ESCAPE 2
+#define AG_JSON_BAD_HEX           3
+#define AG_JSON_BAD_SURROGATE     4
+#define AG_JSON_BAD_ESCAPE        5
+#define AG_JSON_INCOMPLETE_OBJECT 6
+#define AG_JSON_INCOMPLETE_ARRAY  7
+#define AG_JSON_MISMATCHED        8
+
+// Skips the string body and the closing quote, `*pos` points past the opening quote.
+int ag_json_skip_str(const char** pos, const char* end);
+
+// Skips the object or array body and its closing bracket, `*pos` points past the opening `open` bracket.
+int ag_json_skip_nested(const char** pos, const char* end, char open);
+
+// Unescapes the string body [pos, close) to `dst`, which must have (close - pos) bytes,
+// `close` is the closing quote position as found by ag_json_skip_str.
+// Stops after `max_runes` code points if it is > 0. Stores the written size to `*dst_size`.
+int ag_json_unescape(const char* pos, const char* close, char* dst, int64_t max_runes, size_t* dst_size);
+
+// Size of `size` bytes at `src` after JSON string escaping, quotes not included.
+size_t ag_json_escaped_size(const char* src, size_t size);
+
+// Writes `size` bytes at `src` with JSON string escapes to `dst` that must have ag_json_escaped_size bytes.
+// Escapes quotes, backslashes and control chars, leaves UTF-8 sequences intact. Returns the written size.
+size_t ag_json_escape(const char* src, size_t size, char* dst);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif // AG_JSON_SCAN_H_
@@ -0,0 +1,131 @@
+#include "int-map-base.h"
+#include "map-group.h"
+
+size_t ag_int_map_find_index(AgIntMap* map, int64_t key) {
+    if (!map->size)
+        return AG_MAP_NOT_FOUND;
+    uint64_t hash = ag_map_mix_hash((uint64_t)key);
+    int8_t* ctrl = ag_int_map_ctrl(map);
+    int8_t h2 = AG_MAP_H2(hash);
+    AG_MAP_FOR_GROUPS(map, hash, pos) {
+        for (uint32_t m = ag_map_match(ctrl + pos, h2); m; m &= m - 1) {
+            size_t i = pos + ag_map_lowest_bit(m);
+            if (map->buckets[i].key == key)
+                return i;
+        }
+        if (ag_map_match(ctrl + pos, AG_MAP_EMPTY))
+            return AG_MAP_NOT_FOUND;
+    }
+}
+
+static size_t ag_int_map_find_free(AgIntMap* map, uint64_t hash) {
+    int8_t* ctrl = ag_int_map_ctrl(map);
+    AG_MAP_FOR_GROUPS(map, hash, pos) {
+        uint32_t m = ag_map_match_free(ctrl + pos);
+        if (m)
+            return pos + ag_map_lowest_bit(m);
+    }
+}
+
+static void ag_int_map_rehash(AgIntMap* map, size_t new_capacity) {
+    AgIntMapBucket* old_buckets = map->buckets;
+    int8_t* old_ctrl = old_buckets ? ag_int_map_ctrl(map) : NULL;
+    size_t old_cap = map->capacity;
+    map->capacity = new_capacity;
+    map->buckets = ag_alloc(AG_INT_MAP_ALLOC_SIZE(new_capacity));
+    int8_t* ctrl = ag_int_map_ctrl(map);
+    for (size_t i = 0; i < new_capacity; i++)
+        ctrl[i] = AG_MAP_EMPTY;
+    map->growth_left = new_capacity - new_capacity / 8 - map->size;
+    if (!old_buckets)
+        return;
+    for (size_t i = 0; i < old_cap; i++) {
+        if (old_ctrl[i] < 0)
+            continue;
+        size_t di = ag_int_map_find_free(map, ag_map_mix_hash((uint64_t)old_buckets[i].key));
+        ctrl[di] = old_ctrl[i];
+        map->buckets[di] = old_buckets[i];
+    }
+    ag_free(old_buckets);
+}
+
+size_t ag_int_map_insert(AgIntMap* map, int64_t key, bool* inserted) {
+    size_t i = ag_int_map_find_index(map, key);
+    if (i != AG_MAP_NOT_FOUND) {
+        *inserted = false;
+        return i;
+    }
+    if (map->growth_left == 0) {
+        ag_int_map_rehash(map, map->capacity == 0
+            ? AG_MAP_GROUP
+            : map->size * 16 >= map->capacity * 7
+                ? map->capacity << 1
+                : map->capacity);
+    }
+    uint64_t hash = ag_map_mix_hash((uint64_t)key);
+    i = ag_int_map_find_free(map, hash);
+    int8_t* ctrl = ag_int_map_ctrl(map);
+    if (ctrl[i] == AG_MAP_EMPTY)
+        map->growth_left--;
+    ctrl[i] = AG_MAP_H2(hash);
+    map->buckets[i].key = key;
+    map->buckets[i].val.int_val = 0;
+    map->size++;
+    *inserted = true;
+    return i;
+}
+
+bool ag_int_map_used_at(AgIntMap* map, uint64_t index) {
+    return index < map->capacity && ag_int_map_ctrl(map)[index] >= 0;
+}
+
+AgMapVal ag_int_map_delete_at(AgIntMap* map, size_t i) {
+    if (!ag_int_map_used_at(map, i))
+        return (AgMapVal){ 0 };
+    AgMapVal r = map->buckets[i].val;
+    map->buckets[i].val.int_val = 0;
+    map->size--;
+    int8_t* ctrl = ag_int_map_ctrl(map);
+    if (ag_map_match(ctrl + (i & ~(size_t)(AG_MAP_GROUP - 1)), AG_MAP_EMPTY)) {
+        ctrl[i] = AG_MAP_EMPTY;
+        map->growth_left++;
+    } else {
+        ctrl[i] = AG_MAP_DELETED;
+    }
+    return r;
+}
+
+void ag_int_map_clear(
+    AgIntMap* map,
+    void(*val_disposer)(AgMapVal))
+{
+    if (map->buckets == 0)
+        return;
+    if (val_disposer) {
+        int8_t* ctrl = ag_int_map_ctrl(map);
+        for (size_t i = 0; i < map->capacity; i++) {
+            if (ctrl[i] >= 0)
+                val_disposer(map->buckets[i].val);
+        }
+    }
+    ag_free(map->buckets);
+    map->buckets = 0;
+    map->capacity = map->size = map->growth_left = 0;
+}
+
+void ag_int_map_reserve(AgIntMap* map, size_t size) {
+    if (size > map->size + map->growth_left)
+        ag_int_map_rehash(map, ag_map_capacity_for(size));
+}
+
+void ag_int_map_shrink(AgIntMap* map) {
+    if (!map->buckets)
+        return;
+    if (!map->size) {
+        ag_int_map_clear(map, NULL);
+        return;
+    }
+    size_t new_capacity = ag_map_capacity_for(map->size);
+    if (new_capacity < map->capacity || map->size + map->growth_left < map->capacity - map->capacity / 8)  // or has deleted
+        ag_int_map_rehash(map, new_capacity);
+}
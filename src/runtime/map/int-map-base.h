@@ -0,0 +1,94 @@
+#ifndef AK_INT_MAP_BASE_H_
+#define AK_INT_MAP_BASE_H_
+
+// Declarations used by all IntMap types and IntSet
+//
+// Same Swiss table as in map-base, but keys are int64 stored inline,
+// hashed without calls to objects and compared by value.
+// Bucket occupancy is defined by control bytes, since any int is a valid key.
+//
+
+#include "map-base.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    int64_t   key;
+    AgMapVal  val;  // unused in IntSet
+} AgIntMapBucket;
+
+typedef struct {
+    AgObject        head;
+    AgIntMapBucket* buckets;  // followed by `capacity` control bytes in the same allocation
+    size_t          capacity; // 0 or power of 2 >= AG_MAP_GROUP
+    size_t          size;
+    size_t          growth_left;
+} AgIntMap;
+
+#define ag_int_map_ctrl(MAP) ((int8_t*)((MAP)->buckets + (MAP)->capacity))
+#define AG_INT_MAP_ALLOC_SIZE(CAPACITY) ((CAPACITY) * (sizeof(AgIntMapBucket) + 1))
+
+// Returns AG_MAP_NOT_FOUND if not found
+size_t ag_int_map_find_index(
+    AgIntMap* map,
+    int64_t key);
+
+// Returns index of bucket for key, allocates a new one if key is not in the map.
+// New buckets have zero `val`.
+size_t ag_int_map_insert(
+    AgIntMap* map,
+    int64_t key,
+    bool* inserted);
+
+bool ag_int_map_used_at(
+    AgIntMap* map,
+    uint64_t index);
+
+// Removes item at bucket index, it doesn't move other items, so it can be used while iterating
+AgMapVal ag_int_map_delete_at(
+    AgIntMap* map,
+    size_t index);
+
+void ag_int_map_clear(
+    AgIntMap* map,
+    void(*val_disposer)(AgMapVal));
+
+void ag_int_map_reserve(
+    AgIntMap* map,
+    size_t size);
+
+void ag_int_map_shrink(AgIntMap* map);
+
+#define AG_INT_MAP_COPY(VAL_COPIER)                                                   \
+    AgIntMap* s = (AgIntMap*)src;                                                     \
+    AgIntMap* d = (AgIntMap*)dst;                                                     \
+    d->capacity = s->capacity;                                                        \
+    d->size = s->size;                                                                \
+    d->growth_left = s->growth_left;                                                  \
+    d->buckets = s->buckets ? ag_alloc(AG_INT_MAP_ALLOC_SIZE(s->capacity)) : NULL;    \
+    if (d->buckets)                                                                   \
+        ag_memcpy(d->buckets, s->buckets, AG_INT_MAP_ALLOC_SIZE(s->capacity));        \
+    for (size_t n = 0; n < d->capacity; n++) {                                        \
+        if (ag_int_map_ctrl(d)[n] >= 0) {                                             \
+            AgIntMapBucket* i = d->buckets + n;                                       \
+            VAL_COPIER;                                                               \
+        }                                                                             \
+    }
+
+#define AG_INT_MAP_VISIT(VAL_VISITOR)                                                 \
+    if (ag_not_null(map) && map->buckets) {                                           \
+        for (size_t n = 0; n < map->capacity; n++) {                                  \
+            if (ag_int_map_ctrl(map)[n] >= 0) {                                       \
+                AgIntMapBucket* i = map->buckets + n;                                 \
+                VAL_VISITOR;                                                          \
+            }                                                                         \
+        }                                                                             \
+    }
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif // AK_INT_MAP_BASE_H_
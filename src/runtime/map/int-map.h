@@ -0,0 +1,34 @@
+#ifndef AK_INT_MAP_H_
+#define AK_INT_MAP_H_
+
+#include "int-map-base.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int64_t   ag_m_sys_IntMap_size(AgIntMap* map);
+int64_t   ag_m_sys_IntMap_capacity(AgIntMap* map);
+void      ag_m_sys_IntMap_clear(AgIntMap* map);
+AgObject* ag_m_sys_IntMap_getAt(AgIntMap* map, int64_t key);                  // returns ?T
+AgObject* ag_m_sys_IntMap_setAt(AgIntMap* map, int64_t key, AgObject* value); // returns previous object as ?T
+AgObject* ag_m_sys_IntMap_delete(AgIntMap* map, int64_t key);                 // returns previous object as ?T
+void      ag_m_sys_IntMap_reserve(AgIntMap* map, uint64_t size);
+void      ag_m_sys_IntMap_shrinkToFit(AgIntMap* map);
+void      ag_m_sys_IntMap_removeAt(AgIntMap* map, uint64_t index);     // removes by bucket index, safe while iterating
+bool      ag_m_sys_IntMap_usedAt(AgIntMap* map, uint64_t index);
+int64_t   ag_m_sys_IntMap_keyAt(AgIntMap* map, uint64_t index);
+AgObject* ag_m_sys_IntMap_valAt(AgIntMap* map, uint64_t index);
+
+void      ag_copy_sys_IntMap(void* dst, void* src);
+void      ag_dtor_sys_IntMap(void* map);
+void      ag_visit_sys_IntMap(
+             AgIntMap* map,
+             void    (*visitor)(void*, int, void*),
+             void* ctx);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif // AK_INT_MAP_H_
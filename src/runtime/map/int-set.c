@@ -0,0 +1,65 @@
+#include "int-set.h"
+
+int64_t ag_m_sys_IntSet_size(AgIntMap* set) {
+    return set->size;
+}
+
+int64_t ag_m_sys_IntSet_capacity(AgIntMap* set) {
+    return set->capacity;
+}
+
+void ag_m_sys_IntSet_clear(AgIntMap* set) {
+    ag_int_map_clear(set, NULL);
+}
+
+bool ag_m_sys_IntSet_contains(AgIntMap* set, int64_t key) {
+    return ag_int_map_find_index(set, key) != AG_MAP_NOT_FOUND;
+}
+
+bool ag_m_sys_IntSet_add(AgIntMap* set, int64_t key) {
+    bool inserted;
+    ag_int_map_insert(set, key, &inserted);
+    return inserted;
+}
+
+bool ag_m_sys_IntSet_delete(AgIntMap* set, int64_t key) {
+    size_t i = ag_int_map_find_index(set, key);
+    if (i == AG_MAP_NOT_FOUND)
+        return false;
+    ag_int_map_delete_at(set, i);
+    return true;
+}
+
+void ag_m_sys_IntSet_reserve(AgIntMap* set, uint64_t size) {
+    ag_int_map_reserve(set, size);
+}
+
+void ag_m_sys_IntSet_shrinkToFit(AgIntMap* set) {
+    ag_int_map_shrink(set);
+}
+
+void ag_m_sys_IntSet_removeAt(AgIntMap* set, uint64_t index) {
+    ag_int_map_delete_at(set, index);
+}
+
+bool ag_m_sys_IntSet_usedAt(AgIntMap* set, uint64_t index) {
+    return ag_int_map_used_at(set, index);
+}
+
+int64_t ag_m_sys_IntSet_keyAt(AgIntMap* set, uint64_t index) {
+    return ag_int_map_used_at(set, index) ? set->buckets[index].key : 0;
+}
+
+void ag_copy_sys_IntSet(void* dst, void* src) {
+    AG_INT_MAP_COPY((void)i)
+}
+
+void ag_dtor_sys_IntSet(void* set) {
+    ag_m_sys_IntSet_clear((AgIntMap*)set);
+}
+
+void ag_visit_sys_IntSet(
+    AgIntMap* set,
+    void   (*visitor)(void*, int, void*),
+    void*  ctx)
+{}
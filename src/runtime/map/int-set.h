@@ -0,0 +1,33 @@
+#ifndef AK_INT_SET_H_
+#define AK_INT_SET_H_
+
+#include "int-map-base.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int64_t   ag_m_sys_IntSet_size(AgIntMap* set);
+int64_t   ag_m_sys_IntSet_capacity(AgIntMap* set);
+void      ag_m_sys_IntSet_clear(AgIntMap* set);
+bool      ag_m_sys_IntSet_contains(AgIntMap* set, int64_t key);
+bool      ag_m_sys_IntSet_add(AgIntMap* set, int64_t key);       // returns true if key was not in set
+bool      ag_m_sys_IntSet_delete(AgIntMap* set, int64_t key);    // returns true if key was in set
+void      ag_m_sys_IntSet_reserve(AgIntMap* set, uint64_t size);
+void      ag_m_sys_IntSet_shrinkToFit(AgIntMap* set);
+void      ag_m_sys_IntSet_removeAt(AgIntMap* set, uint64_t index);  // removes by bucket index, safe while iterating
+bool      ag_m_sys_IntSet_usedAt(AgIntMap* set, uint64_t index);
+int64_t   ag_m_sys_IntSet_keyAt(AgIntMap* set, uint64_t index);
+
+void      ag_copy_sys_IntSet(void* dst, void* src);
+void      ag_dtor_sys_IntSet(void* set);
+void      ag_visit_sys_IntSet(
+             AgIntMap* set,
+             void    (*visitor)(void*, int, void*),
+             void* ctx);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif // AK_INT_SET_H_
@@ -1,4 +1,9 @@
 #include "map-base.h"
+#include "map-group.h"
+
+uint64_t ag_map_hash(AgObject* key) {
+    return ag_hash_mix((uint64_t)ag_fn_sys_hash(key) ^ ag_hash_seed, AG_HASH_SECRET1);
+}
 
 AgObject* ag_map_key_at(AgMap* map, uint64_t index) {
     if (index >= map->capacity)
@@ -8,50 +13,55 @@ AgObject* ag_map_key_at(AgMap* map, uint64_t index) {
     return r;
 }
 
-size_t ag_map_find_index(AgMap* map, AgObject* key, size_t hash) { // returns ~0u if not found
-    if (!map->buckets)
-        return ~0u;
-    uint64_t dist = 0;
-    for (size_t i = hash;; i++) {
-        i &= map->capacity - 1;
-        AgMapBucket* b = map->buckets + i;
-        if (!b->key || b->dist < dist)
-            return ~0u;
-        if (ag_eq_shared(b->key, key))
-            return i;
-        dist = b->dist;
+size_t ag_map_find_index(AgMap* map, AgObject* key, uint64_t hash) {
+    if (!map->size)
+        return AG_MAP_NOT_FOUND;
+    int8_t* ctrl = ag_map_ctrl(map);
+    int8_t h2 = AG_MAP_H2(hash);
+    AG_MAP_FOR_GROUPS(map, hash, pos) {
+        for (uint32_t m = ag_map_match(ctrl + pos, h2); m; m &= m - 1) {
+            size_t i = pos + ag_map_lowest_bit(m);
+            AgMapBucket* b = map->buckets + i;
+            if (b->hash == hash && ag_eq_shared(b->key, key))
+                return i;
+        }
+        if (ag_map_match(ctrl + pos, AG_MAP_EMPTY))
+            return AG_MAP_NOT_FOUND;
     }
 }
 
-void ag_map_insert(
-    AgMap* map,
-    size_t     i,
-    uint64_t   dist,
-    int64_t    hash,
-    AgObject*  key,
-    AgMapVal   value)
-{
-    for (;; i++, dist++) {
-        i &= map->capacity - 1;
-        AgMapBucket* b = map->buckets + i;
-        if (!b->key) {
-            b->dist = dist;
-            b->key = key;
-            b->val = value;
-            return;
-        }
-        if (b->dist < dist) {
-            AgObject* t_key = b->key;
-            b->key = key;
-            key = t_key;
-            AgMapVal t_value = b->val;
-            b->val = value;
-            value = t_value;
-            uint64_t t_dist = b->dist;
-            b->dist = dist;
-            dist = t_dist;
-        }
+// Returns index of first empty or deleted bucket in probe sequence of `hash`
+static size_t ag_map_find_free(AgMap* map, uint64_t hash) {
+    int8_t* ctrl = ag_map_ctrl(map);
+    AG_MAP_FOR_GROUPS(map, hash, pos) {
+        uint32_t m = ag_map_match_free(ctrl + pos);
+        if (m)
+            return pos + ag_map_lowest_bit(m);
+    }
+}
+
+static void ag_map_rehash(AgMap* map, size_t new_capacity) {
+    AgMapBucket* old_buckets = map->buckets;
+    int8_t* old_ctrl = old_buckets ? ag_map_ctrl(map) : NULL;
+    size_t old_cap = map->capacity;
+    map->capacity = new_capacity;
+    map->buckets = ag_alloc(AG_MAP_ALLOC_SIZE(new_capacity));
+    ag_zero_mem(map->buckets, sizeof(AgMapBucket) * new_capacity);
+    int8_t* ctrl = ag_map_ctrl(map);
+    for (size_t i = 0; i < new_capacity; i++)
+        ctrl[i] = AG_MAP_EMPTY;
+    map->growth_left = new_capacity - new_capacity / 8 - map->size;
+    if (!old_buckets)
+        return;
+    for (size_t i = 0; i < old_cap; i++) {
+        if (old_ctrl[i] < 0)
+            continue;
+        AgMapBucket* src = old_buckets + i;
+        size_t di = ag_map_find_free(map, src->hash);
+        ctrl[di] = old_ctrl[i];
+        map->buckets[di] = *src;
     }
+    ag_free(old_buckets);
 }
 
 void ag_map_clear(
@@ -69,93 +79,109 @@ void ag_map_clear(
     }
     ag_free(map->buckets);
     map->buckets = 0;
-    map->capacity = map->size = 0;
+    map->capacity = map->size = map->growth_left = 0;
 }
 
-AgMapVal ag_map_set_at(
+void ag_map_reserve(AgMap* map, size_t size) {
+    if (size > map->size + map->growth_left)
+        ag_map_rehash(map, ag_map_capacity_for(size));
+}
+
+void ag_map_shrink(AgMap* map) {
+    if (!map->buckets)
+        return;
+    if (!map->size) {
+        ag_free(map->buckets);
+        map->buckets = 0;
+        map->capacity = map->growth_left = 0;
+        return;
+    }
+    size_t new_capacity = ag_map_capacity_for(map->size);
+    if (new_capacity < map->capacity || map->size + map->growth_left < map->capacity - map->capacity / 8)  // or has deleted
+        ag_map_rehash(map, new_capacity);
+}
+
+static AgMapVal ag_map_set_hashed(
     AgMap* map,
     AgObject* key,
+    uint64_t hash,
     AgMapVal value)
 {
-    if (map->size >= map->capacity * 3 / 4) {  // rehash
-        size_t old_cap = map->capacity;
-        AgMapBucket* old_buckets = map->buckets;
-        map->capacity = map->capacity
-            ? map->capacity << 1
-            : 16;
-        map->buckets = ag_alloc(sizeof(AgMapBucket) * map->capacity);
-        ag_zero_mem(map->buckets, sizeof(AgMapBucket) * map->capacity);
-        if (old_buckets) {
-            for (AgMapBucket* i = old_buckets, *j = old_buckets + old_cap; i < j; i++) {
-                if (i->key) {
-                    uint64_t hash = ag_fn_sys_hash(i->key);
-                    ag_map_insert(
-                        map,
-                        hash & (map->capacity - 1), // initial insertion position
-                        0, // dist
-                        hash,
-                        i->key,
-                        i->val);
-                }
-            }
-            ag_free(old_buckets);
-        }
+    size_t i = ag_map_find_index(map, key, hash);
+    if (i != AG_MAP_NOT_FOUND) {
+        AgMapVal r = map->buckets[i].val;
+        map->buckets[i].val = value;
+        return r;
     }
-    uint64_t hash = ag_fn_sys_hash(key);
-    uint64_t dist = 0;
-    for (size_t i = hash;; i++, dist++) {
-        i &= map->capacity - 1;
-        AgMapBucket* b = map->buckets + i;
-        if (!b->key) {
-            b->dist = dist;
-            ag_retain_shared(key);
-            b->key = key;
-            b->val = value;
-            return (AgMapVal) { 0 };
-        }
-        if (ag_eq_shared(b->key, key)) {
-            AgMapVal r = b->val;
-            b->val = value;
-            return r;
-        }
-        if (b->dist < dist) {
-            AgObject* t_key = b->key;
-            AgMapVal t_value = b->val;
-            uint64_t t_dist = b->dist;
-            ag_retain_shared(key);
-            b->key = key;
-            b->val = value;
-            b->dist = dist;
-            ag_map_insert(map, i, t_dist, ag_fn_sys_hash(t_key), t_key, t_value);
-            return (AgMapVal){ 0 };
-        }
+    if (map->growth_left == 0) {
+        // Grow if at least half of the usable space is taken by live items, otherwise just purge deleted ones
+        ag_map_rehash(map, map->capacity == 0
+            ? AG_MAP_GROUP
+            : map->size * 16 >= map->capacity * 7
+                ? map->capacity << 1
+                : map->capacity);
     }
+    i = ag_map_find_free(map, hash);
+    int8_t* ctrl = ag_map_ctrl(map);
+    if (ctrl[i] == AG_MAP_EMPTY)
+        map->growth_left--;
+    ctrl[i] = AG_MAP_H2(hash);
+    AgMapBucket* b = map->buckets + i;
+    ag_retain_shared(key);
+    b->key = key;
+    b->val = value;
+    b->hash = hash;
+    map->size++;
+    return (AgMapVal){ 0 };
 }
 
-AgMapVal ag_map_delete(AgMap* map, AgObject* key) {
-    size_t ri = ag_map_find_index(map, key, ag_fn_sys_hash(key));
-    if (ri == ~0u)
+AgMapVal ag_map_set_at(
+    AgMap* map,
+    AgObject* key,
+    AgMapVal value)
+{
+    return ag_map_set_hashed(map, key, ag_map_hash(key), value);
+}
+
+void ag_map_set_all(
+    AgMap* map,
+    AgMap* src,
+    void(*val_retainer)(AgMapVal),
+    void(*val_disposer)(AgMapVal))
+{
+    if (!src->size)
+        return;
+    ag_map_reserve(map, map->size + src->size);
+    for (AgMapBucket* i = src->buckets, *j = src->buckets + src->capacity; i < j; i++) {
+        if (!i->key) continue;
+        val_retainer(i->val);
+        val_disposer(ag_map_set_hashed(map, i->key, i->hash, i->val));
+    }
+}
+
+AgMapVal ag_map_delete_at(AgMap* map, size_t i) {
+    if (i >= map->capacity || !map->buckets[i].key)
         return (AgMapVal){ 0 };
-    AgMapBucket* rb = map->buckets + ri;
-    ag_release_shared(rb->key);
-    AgMapVal r = rb->val;
-    rb->key = 0;
-    rb->val.int_val = 0;
-    AgMapBucket* cur = map->buckets + ri;
-    AgMapBucket* term = map->buckets + map->capacity;
-    for (;;) {
-        AgMapBucket* next = ++cur;
-        if (next == term)
-            next = map->buckets;
-        if (next == rb || !next->key || next->dist == 0) // full loop or empty slot or element on its place
-            break;
-        cur->key = next->key;
-        cur->val = next->val;
-        cur->dist = next->dist - 1;
-        next->key = 0;
-        next->val.int_val = 0;
-        next->dist = 0;
-        cur = next;
+    AgMapBucket* b = map->buckets + i;
+    ag_release_shared(b->key);
+    AgMapVal r = b->val;
+    b->key = 0;
+    b->val.int_val = 0;
+    map->size--;
+    // If group has empty slots, no probe sequence passes through it, so this slot can become empty.
+    int8_t* group = ag_map_ctrl(map) + (i & ~(size_t)(AG_MAP_GROUP - 1));
+    if (ag_map_match(group, AG_MAP_EMPTY)) {
+        ag_map_ctrl(map)[i] = AG_MAP_EMPTY;
+        map->growth_left++;
+    } else {
+        ag_map_ctrl(map)[i] = AG_MAP_DELETED;
     }
     return r;
 }
+
+AgMapVal ag_map_delete(AgMap* map, AgObject* key) {
+    size_t i = ag_map_find_index(map, key, ag_map_hash(key));
+    return i == AG_MAP_NOT_FOUND
+        ? (AgMapVal){ 0 }
+        : ag_map_delete_at(map, i);
+}
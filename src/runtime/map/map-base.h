@@ -5,8 +5,9 @@
 //
 // Open addressed
 // Pow_2 grow
-// Linear probe
-// Robinhood hashing
+// Swiss table: one control byte per bucket holding 7 bits of hash,
+// probed by groups of AG_MAP_GROUP control bytes at once (SSE2 where available)
+// Full hashes are stored in buckets, so rehash never touches keys
 //
 
 #include "runtime.h"
@@ -23,32 +24,36 @@ typedef union {
 } AgMapVal;
 
 typedef struct {
-    AgObject* key;   // shared. 0 - empty
+    AgObject* key;   // shared. 0 - empty or deleted
     AgMapVal  val;
-    uint64_t  dist;  // distance from ideal position
+    uint64_t  hash;  // mixed hash of the key
 } AgMapBucket;
 
+// Control bytes
+#define AG_MAP_EMPTY   ((int8_t)-128)
+#define AG_MAP_DELETED ((int8_t)-2)
+// 0..127 - occupied, 7 lower bits of hash
+#define AG_MAP_GROUP 16
+
 typedef struct {
     AgObject     head;
-    AgMapBucket* buckets;
-    size_t       capacity; // must be power of 2
+    AgMapBucket* buckets;  // followed by `capacity` control bytes in the same allocation
+    size_t       capacity; // 0 or power of 2 >= AG_MAP_GROUP
     size_t       size;
+    size_t       growth_left;  // empty buckets that can be filled before rehash
 } AgMap;
 
-size_t ag_map_find_index(
-    AgMap* map,
-    AgObject* key,
-    size_t hash);
+#define ag_map_ctrl(MAP) ((int8_t*)((MAP)->buckets + (MAP)->capacity))
+#define AG_MAP_ALLOC_SIZE(CAPACITY) ((CAPACITY) * (sizeof(AgMapBucket) + 1))
+#define AG_MAP_NOT_FOUND (~(size_t)0)
 
-// Inserts the prelocked key-value, starting at pos `i`.
-// It is guaranteed that `key` is not in the map
-void ag_map_insert(
+uint64_t ag_map_hash(AgObject* key);
+
+// Returns AG_MAP_NOT_FOUND if not found
+size_t ag_map_find_index(
     AgMap* map,
-    size_t    i,
-    uint64_t  dist,
-    int64_t   hash,
     AgObject* key,
-    AgMapVal  value);
+    uint64_t hash);
 
 AgObject* ag_map_key_at(
     AgMap* map,
@@ -67,13 +72,35 @@ AgMapVal ag_map_delete(
     AgMap* map,
     AgObject* key);
 
+// Removes item at bucket index, it doesn't move other items, so it can be used while iterating
+AgMapVal ag_map_delete_at(
+    AgMap* map,
+    size_t index);
+
+// Sets all items from `src` reusing its stored hashes
+void ag_map_set_all(
+    AgMap* map,
+    AgMap* src,
+    void(*val_retainer)(AgMapVal),
+    void(*val_disposer)(AgMapVal));
+
+// Makes map able to hold `size` items without rehash
+void ag_map_reserve(
+    AgMap* map,
+    size_t size);
+
+// Minimizes capacity and purges deleted buckets
+void ag_map_shrink(AgMap* map);
+
 #define AG_MAP_COPY(VAL_COPIER)                                                     \
     AgMap* s = (AgMap*)src;                                                         \
     AgMap* d = (AgMap*)dst;                                                         \
     d->capacity = s->capacity;                                                      \
     d->size = s->size;                                                              \
-    d->buckets = ag_alloc(s->capacity * sizeof(AgMapBucket));                       \
-    ag_memcpy(d->buckets, s->buckets, s->capacity * sizeof(AgMapBucket));           \
+    d->growth_left = s->growth_left;                                                \
+    d->buckets = s->buckets ? ag_alloc(AG_MAP_ALLOC_SIZE(s->capacity)) : NULL;      \
+    if (d->buckets)                                                                 \
+        ag_memcpy(d->buckets, s->buckets, AG_MAP_ALLOC_SIZE(s->capacity));          \
     for (AgMapBucket* i = d->buckets, *n = d->buckets + d->capacity; i < n; i++) {  \
         if (i->key) {                                                               \
             ag_retain_shared(i->key);                                               \
@@ -0,0 +1,74 @@
+#ifndef AK_MAP_GROUP_H_
+#define AK_MAP_GROUP_H_
+
+// Control-byte group probing shared by all Swiss-table based containers
+// Included only in implementation files
+
+#include "map-base.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define AG_MAP_SSE2
+#endif
+
+// Keyed with the per process `ag_hash_seed`, so integer keys colliding in buckets can't be crafted in advance
+static inline uint64_t ag_map_mix_hash(uint64_t h) {
+    return ag_hash_mix(h ^ ag_hash_seed, AG_HASH_SECRET1);
+}
+
+#define AG_MAP_H1(HASH) ((size_t)((HASH) >> 7))
+#define AG_MAP_H2(HASH) ((int8_t)((HASH) & 0x7f))
+
+// Bit N of result is set if group[N] == val
+static inline uint32_t ag_map_match(int8_t* group, int8_t val) {
+#ifdef AG_MAP_SSE2
+    __m128i ctrl = _mm_loadu_si128((const __m128i*)group);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(val)));
+#else
+    uint32_t r = 0;
+    for (int i = 0; i < AG_MAP_GROUP; i++)
+        r |= (uint32_t)(group[i] == val) << i;
+    return r;
+#endif
+}
+
+// Bit N of result is set if group[N] is empty or deleted
+static inline uint32_t ag_map_match_free(int8_t* group) {
+#ifdef AG_MAP_SSE2
+    return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)group));
+#else
+    uint32_t r = 0;
+    for (int i = 0; i < AG_MAP_GROUP; i++)
+        r |= (uint32_t)(group[i] < 0) << i;
+    return r;
+#endif
+}
+
+static inline int ag_map_lowest_bit(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(mask);
+#else
+    int r = 0;
+    while ((mask & 1) == 0) {
+        mask >>= 1;
+        r++;
+    }
+    return r;
+#endif
+}
+
+// Groups are aligned to AG_MAP_GROUP and probed in triangular sequence, that visits every group once.
+#define AG_MAP_FOR_GROUPS(MAP, HASH, POS)                                         \
+    for (size_t POS = AG_MAP_H1(HASH) & ((MAP)->capacity - 1) & ~(size_t)(AG_MAP_GROUP - 1), \
+        ag_step = 0;;                                                             \
+        ag_step += AG_MAP_GROUP, POS = (POS + ag_step) & ((MAP)->capacity - 1))
+
+// Smallest capacity that holds `size` items without rehash
+static inline size_t ag_map_capacity_for(size_t size) {
+    size_t r = AG_MAP_GROUP;
+    while (r - r / 8 < size)
+        r <<= 1;
+    return r;
+}
+
+#endif // AK_MAP_GROUP_H_
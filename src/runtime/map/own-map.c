@@ -17,8 +17,8 @@ void ag_m_sys_Map_clear(AgMap* map) {
 }
 
 AgObject* ag_m_sys_Map_getAt(AgMap* map, AgObject* key) {
-    size_t i = ag_map_find_index(map, key, ag_fn_sys_hash(key));
-    if (i == ~0u)
+    size_t i = ag_map_find_index(map, key, ag_map_hash(key));
+    if (i == AG_MAP_NOT_FOUND)
         return 0;
     AgObject* r = map->buckets[i].val.ptr_val;
     ag_retain_pin(r);
@@ -38,6 +38,18 @@ AgObject* ag_m_sys_Map_delete(AgMap* map, AgObject* key) {
     return r.ptr_val;
 }
 
+void ag_m_sys_Map_reserve(AgMap* map, uint64_t size) {
+    ag_map_reserve(map, size);
+}
+
+void ag_m_sys_Map_shrinkToFit(AgMap* map) {
+    ag_map_shrink(map);
+}
+
+void ag_m_sys_Map_removeAt(AgMap* map, uint64_t index) {
+    val_diposer(ag_map_delete_at(map, index));
+}
+
 AgObject* ag_m_sys_Map_keyAt(AgMap* map, uint64_t index) {
     return ag_map_key_at(map, index);
 }
@@ -13,6 +13,9 @@ void      ag_m_sys_Map_clear(AgMap* map);
 AgObject* ag_m_sys_Map_getAt(AgMap* map, AgObject* key);                  // returns ?T
 AgObject* ag_m_sys_Map_setAt(AgMap* map, AgObject* key, AgObject* value); // returns previous object as ?T
 AgObject* ag_m_sys_Map_delete(AgMap* map, AgObject* key);                 // returns previous object as ?T
+void      ag_m_sys_Map_reserve(AgMap* map, uint64_t size);
+void      ag_m_sys_Map_shrinkToFit(AgMap* map);
+void      ag_m_sys_Map_removeAt(AgMap* map, uint64_t index);     // removes by bucket index, safe while iterating
 AgObject* ag_m_sys_Map_keyAt(AgMap* map, uint64_t index);
 AgObject* ag_m_sys_Map_valAt(AgMap* map, uint64_t index);
 
@@ -0,0 +1,85 @@
+#include "shared-int-map.h"
+
+int64_t ag_m_sys_SharedIntMap_size(AgIntMap* map) {
+    return map->size;
+}
+
+int64_t ag_m_sys_SharedIntMap_capacity(AgIntMap* map) {
+    return map->capacity;
+}
+
+static void val_shared_diposer(AgMapVal v) {
+    ag_release_shared(v.ptr_val);
+}
+
+void ag_m_sys_SharedIntMap_clear(AgIntMap* map) {
+    ag_int_map_clear(map, val_shared_diposer);
+}
+
+AgObject* ag_m_sys_SharedIntMap_getAt(AgIntMap* map, int64_t key) {
+    size_t i = ag_int_map_find_index(map, key);
+    if (i == AG_MAP_NOT_FOUND)
+        return 0;
+    AgObject* r = map->buckets[i].val.ptr_val;
+    ag_retain_shared(r);
+    return r;
+}
+
+AgObject* ag_m_sys_SharedIntMap_setAt(AgIntMap* map, int64_t key, AgObject* value) {
+    ag_retain_shared(value);
+    bool inserted;
+    size_t i = ag_int_map_insert(map, key, &inserted);
+    AgIntMapBucket* b = map->buckets + i;
+    AgObject* r = b->val.ptr_val;
+    b->val.ptr_val = value;
+    return r;
+}
+
+AgObject* ag_m_sys_SharedIntMap_delete(AgIntMap* map, int64_t key) {
+    AgObject* r = ag_int_map_delete_at(map, ag_int_map_find_index(map, key)).ptr_val;
+    return r;
+}
+
+void ag_m_sys_SharedIntMap_reserve(AgIntMap* map, uint64_t size) {
+    ag_int_map_reserve(map, size);
+}
+
+void ag_m_sys_SharedIntMap_shrinkToFit(AgIntMap* map) {
+    ag_int_map_shrink(map);
+}
+
+void ag_m_sys_SharedIntMap_removeAt(AgIntMap* map, uint64_t index) {
+    val_shared_diposer(ag_int_map_delete_at(map, index));
+}
+
+bool ag_m_sys_SharedIntMap_usedAt(AgIntMap* map, uint64_t index) {
+    return ag_int_map_used_at(map, index);
+}
+
+int64_t ag_m_sys_SharedIntMap_keyAt(AgIntMap* map, uint64_t index) {
+    return ag_int_map_used_at(map, index) ? map->buckets[index].key : 0;
+}
+
+AgObject* ag_m_sys_SharedIntMap_valAt(AgIntMap* map, uint64_t index) {
+    if (!ag_int_map_used_at(map, index))
+        return 0;
+    AgObject* r = map->buckets[index].val.ptr_val;
+    ag_retain_shared(r);
+    return r;
+}
+
+void ag_copy_sys_SharedIntMap(void* dst, void* src) {
+    AG_INT_MAP_COPY(ag_retain_shared(i->val.ptr_val))
+}
+
+void ag_dtor_sys_SharedIntMap(void* map) {
+    ag_m_sys_SharedIntMap_clear((AgIntMap*)map);
+}
+
+void ag_visit_sys_SharedIntMap(
+    AgIntMap* map,
+    void   (*visitor)(void*, int, void*),
+    void*  ctx)
+{
+    AG_INT_MAP_VISIT(if (i->val.ptr_val) visitor(&i->val.ptr_val, AG_VISIT_OWN, ctx))
+}
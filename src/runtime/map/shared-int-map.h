@@ -0,0 +1,34 @@
+#ifndef AK_SHARED_INT_MAP_H_
+#define AK_SHARED_INT_MAP_H_
+
+#include "int-map-base.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int64_t   ag_m_sys_SharedIntMap_size(AgIntMap* map);
+int64_t   ag_m_sys_SharedIntMap_capacity(AgIntMap* map);
+void      ag_m_sys_SharedIntMap_clear(AgIntMap* map);
+AgObject* ag_m_sys_SharedIntMap_getAt(AgIntMap* map, int64_t key);                  // returns ?*T
+AgObject* ag_m_sys_SharedIntMap_setAt(AgIntMap* map, int64_t key, AgObject* value); // returns previous object as ?*T
+AgObject* ag_m_sys_SharedIntMap_delete(AgIntMap* map, int64_t key);                 // returns previous object as ?*T
+void      ag_m_sys_SharedIntMap_reserve(AgIntMap* map, uint64_t size);
+void      ag_m_sys_SharedIntMap_shrinkToFit(AgIntMap* map);
+void      ag_m_sys_SharedIntMap_removeAt(AgIntMap* map, uint64_t index);     // removes by bucket index, safe while iterating
+bool      ag_m_sys_SharedIntMap_usedAt(AgIntMap* map, uint64_t index);
+int64_t   ag_m_sys_SharedIntMap_keyAt(AgIntMap* map, uint64_t index);
+AgObject* ag_m_sys_SharedIntMap_valAt(AgIntMap* map, uint64_t index);
+
+void      ag_copy_sys_SharedIntMap(void* dst, void* src);
+void      ag_dtor_sys_SharedIntMap(void* map);
+void      ag_visit_sys_SharedIntMap(
+             AgIntMap* map,
+             void    (*visitor)(void*, int, void*),
+             void* ctx);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif // AK_SHARED_INT_MAP_H_
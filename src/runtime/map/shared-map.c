@@ -17,8 +17,8 @@ void ag_m_sys_SharedMap_clear(AgMap* map) {
 }
 
 AgObject* ag_m_sys_SharedMap_getAt(AgMap* map, AgObject* key) {
-    size_t i = ag_map_find_index(map, key, ag_fn_sys_hash(key));
-    if (i == ~0u)
+    size_t i = ag_map_find_index(map, key, ag_map_hash(key));
+    if (i == AG_MAP_NOT_FOUND)
         return 0;
     AgObject* r = map->buckets[i].val.ptr_val;
     ag_retain_shared(r);
@@ -34,6 +34,26 @@ AgObject* ag_m_sys_SharedMap_delete(AgMap* map, AgObject* key) {
     return ag_map_delete(map, key).ptr_val;
 }
 
+void ag_m_sys_SharedMap_reserve(AgMap* map, uint64_t size) {
+    ag_map_reserve(map, size);
+}
+
+void ag_m_sys_SharedMap_shrinkToFit(AgMap* map) {
+    ag_map_shrink(map);
+}
+
+void ag_m_sys_SharedMap_removeAt(AgMap* map, uint64_t index) {
+    val_shared_diposer(ag_map_delete_at(map, index));
+}
+
+static void val_shared_retainer(AgMapVal v) {
+    ag_retain_shared(v.ptr_val);
+}
+
+void ag_m_sys_SharedMap_setAll(AgMap* map, AgMap* src) {
+    ag_map_set_all(map, src, val_shared_retainer, val_shared_diposer);
+}
+
 AgObject* ag_m_sys_SharedMap_keyAt(AgMap* map, uint64_t index) {
     return ag_map_key_at(map, index);
 }
@@ -13,6 +13,10 @@ extern "C" {
     AgObject* ag_m_sys_SharedMap_getAt(AgMap* map, AgObject* key);                  // returns ?*T
     AgObject* ag_m_sys_SharedMap_setAt(AgMap* map, AgObject* key, AgObject* value); // returns previous object as ?*T
     AgObject* ag_m_sys_SharedMap_delete(AgMap* map, AgObject* key);                 // returns previous object as ?*T
+    void      ag_m_sys_SharedMap_reserve(AgMap* map, uint64_t size);
+    void      ag_m_sys_SharedMap_shrinkToFit(AgMap* map);
+    void      ag_m_sys_SharedMap_removeAt(AgMap* map, uint64_t index);     // removes by bucket index, safe while iterating
+    void      ag_m_sys_SharedMap_setAll(AgMap* map, AgMap* src);
     AgObject* ag_m_sys_SharedMap_keyAt(AgMap* map, uint64_t index);
     AgObject* ag_m_sys_SharedMap_valAt(AgMap* map, uint64_t index);
 
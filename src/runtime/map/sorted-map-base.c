@@ -0,0 +1,498 @@
+#include <string.h>
+#include "sorted-map-base.h"
+
+#define AG_BTREE_MIN (AG_BTREE_WIDTH / 2)  // min fill of all nodes but root
+
+static inline bool ag_btree_less(AgBTreeKey a, AgBTreeKey b, bool str_keys) {
+    return str_keys
+        ? ag_compare_strings(a.s, b.s) < 0
+        : a.i < b.i;
+}
+
+static inline void ag_btree_retain_key(AgBTreeKey k, bool str_keys) {
+    if (str_keys)
+        ag_retain_shared(&k.s->head);
+}
+
+static inline void ag_btree_release_key(AgBTreeKey k, bool str_keys) {
+    if (str_keys)
+        ag_release_shared(&k.s->head);
+}
+
+// Returns index of the first key >= `key` (or > `key` if `upper`)
+static size_t ag_btree_leaf_bound(AgBTreeLeaf* leaf, AgBTreeKey key, bool str_keys, bool upper) {
+    size_t lo = 0, hi = leaf->node.count;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (upper
+            ? !ag_btree_less(key, leaf->keys[mid], str_keys)
+            : ag_btree_less(leaf->keys[mid], key, str_keys))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+// Returns index of the child that may contain `key` (or keys > `key` if `upper`)
+static size_t ag_btree_child_index(AgBTreeInner* n, AgBTreeKey key, bool str_keys, bool upper) {
+    size_t lo = 1, hi = n->node.count;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (upper
+            ? !ag_btree_less(key, n->keys[mid], str_keys)
+            : ag_btree_less(n->keys[mid], key, str_keys))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo - 1;
+}
+
+static size_t ag_btree_node_size(AgBTreeNode* n) {
+    if (n->is_leaf)
+        return n->count;
+    size_t r = 0;
+    AgBTreeInner* in = (AgBTreeInner*)n;
+    for (size_t i = 0; i < n->count; i++)
+        r += in->sizes[i];
+    return r;
+}
+
+static AgBTreeLeaf* ag_btree_alloc_leaf() {
+    AgBTreeLeaf* r = ag_alloc(sizeof(AgBTreeLeaf));
+    r->node.count = 0;
+    r->node.is_leaf = 1;
+    r->prev = r->next = NULL;
+    return r;
+}
+
+static AgBTreeInner* ag_btree_alloc_inner() {
+    AgBTreeInner* r = ag_alloc(sizeof(AgBTreeInner));
+    r->node.count = 0;
+    r->node.is_leaf = 0;
+    return r;
+}
+
+AgMapVal* ag_sorted_map_find(AgSortedMap* map, AgBTreeKey key, bool str_keys) {
+    AgBTreeNode* n = map->root;
+    if (!n)
+        return NULL;
+    while (!n->is_leaf)
+        n = ((AgBTreeInner*)n)->children[ag_btree_child_index((AgBTreeInner*)n, key, str_keys, true)];
+    AgBTreeLeaf* leaf = (AgBTreeLeaf*)n;
+    size_t i = ag_btree_leaf_bound(leaf, key, str_keys, false);
+    return i < n->count && !ag_btree_less(key, leaf->keys[i], str_keys)
+        ? leaf->vals + i
+        : NULL;
+}
+
+size_t ag_sorted_map_bound(AgSortedMap* map, AgBTreeKey key, bool str_keys, bool upper) {
+    AgBTreeNode* n = map->root;
+    if (!n)
+        return 0;
+    size_t rank = 0;
+    while (!n->is_leaf) {
+        AgBTreeInner* in = (AgBTreeInner*)n;
+        size_t c = ag_btree_child_index(in, key, str_keys, upper);
+        for (size_t i = 0; i < c; i++)
+            rank += in->sizes[i];
+        n = in->children[c];
+    }
+    return rank + ag_btree_leaf_bound((AgBTreeLeaf*)n, key, str_keys, upper);
+}
+
+static AgBTreeLeaf* ag_sorted_map_descend(AgSortedMap* map, uint64_t rank, size_t* index) {
+    AgBTreeNode* n = map->root;
+    size_t i = rank;
+    while (!n->is_leaf) {
+        AgBTreeInner* in = (AgBTreeInner*)n;
+        size_t c = 0;
+        for (; i >= in->sizes[c]; c++)
+            i -= in->sizes[c];
+        n = in->children[c];
+    }
+    *index = i;
+    return (AgBTreeLeaf*)n;
+}
+
+AgBTreeLeaf* ag_sorted_map_at(AgSortedMap* map, uint64_t rank, size_t* index) {
+    if (rank >= map->size)
+        return NULL;
+    // Frozen maps can be read by many threads at once, so they don't touch the cursor.
+    if (map->head.ctr_mt & AG_CTR_SHARED)
+        return ag_sorted_map_descend(map, rank, index);
+    AgBTreeLeaf* leaf = map->cursor_leaf;
+    if (leaf && rank == map->cursor_rank + 1) {
+        if (++map->cursor_index == leaf->node.count) {
+            map->cursor_leaf = leaf = leaf->next;
+            map->cursor_index = 0;
+        }
+    } else if (leaf && rank + 1 == map->cursor_rank) {
+        if (map->cursor_index-- == 0) {
+            map->cursor_leaf = leaf = leaf->prev;
+            map->cursor_index = leaf->node.count - 1;
+        }
+    } else if (!leaf || rank != map->cursor_rank) {
+        map->cursor_leaf = leaf = ag_sorted_map_descend(map, rank, &map->cursor_index);
+    }
+    map->cursor_rank = rank;
+    *index = map->cursor_index;
+    return leaf;
+}
+
+//
+// Insertion
+//
+
+// Inserts `child` having `child_size` items and lowest key `key` at position `at` of not full inner node
+static void ag_btree_insert_child(AgBTreeInner* n, size_t at, AgBTreeKey key, AgBTreeNode* child, size_t child_size) {
+    size_t tail = n->node.count - at;
+    ag_memmove(n->keys + at + 1, n->keys + at, tail * sizeof(AgBTreeKey));
+    ag_memmove(n->children + at + 1, n->children + at, tail * sizeof(AgBTreeNode*));
+    ag_memmove(n->sizes + at + 1, n->sizes + at, tail * sizeof(size_t));
+    n->keys[at] = key;
+    n->children[at] = child;
+    n->sizes[at] = child_size;
+    n->node.count++;
+}
+
+// Returns the new right sibling if `n` got split, its lowest key goes to `*split_key` (owned by the caller)
+static AgBTreeNode* ag_btree_insert(
+    AgBTreeNode* n,
+    AgBTreeKey key,
+    bool str_keys,
+    AgMapVal** slot,
+    bool* inserted,
+    AgBTreeKey* split_key)
+{
+    if (n->is_leaf) {
+        AgBTreeLeaf* leaf = (AgBTreeLeaf*)n;
+        size_t i = ag_btree_leaf_bound(leaf, key, str_keys, false);
+        if (i < n->count && !ag_btree_less(key, leaf->keys[i], str_keys)) {
+            *slot = leaf->vals + i;
+            *inserted = false;
+            return NULL;
+        }
+        *inserted = true;
+        AgBTreeLeaf* right = NULL;
+        if (n->count == AG_BTREE_WIDTH) {
+            right = ag_btree_alloc_leaf();
+            right->node.count = AG_BTREE_WIDTH - AG_BTREE_MIN;
+            ag_memcpy(right->keys, leaf->keys + AG_BTREE_MIN, right->node.count * sizeof(AgBTreeKey));
+            ag_memcpy(right->vals, leaf->vals + AG_BTREE_MIN, right->node.count * sizeof(AgMapVal));
+            n->count = AG_BTREE_MIN;
+            right->prev = leaf;
+            right->next = leaf->next;
+            if (leaf->next)
+                leaf->next->prev = right;
+            leaf->next = right;
+            if (i > AG_BTREE_MIN) {
+                i -= AG_BTREE_MIN;
+                leaf = right;
+            }
+        }
+        size_t tail = leaf->node.count - i;
+        ag_memmove(leaf->keys + i + 1, leaf->keys + i, tail * sizeof(AgBTreeKey));
+        ag_memmove(leaf->vals + i + 1, leaf->vals + i, tail * sizeof(AgMapVal));
+        ag_btree_retain_key(key, str_keys);
+        leaf->keys[i] = key;
+        leaf->vals[i].int_val = 0;
+        leaf->node.count++;
+        *slot = leaf->vals + i;
+        if (!right)
+            return NULL;
+        *split_key = right->keys[0];
+        ag_btree_retain_key(*split_key, str_keys);
+        return &right->node;
+    }
+    AgBTreeInner* in = (AgBTreeInner*)n;
+    size_t c = ag_btree_child_index(in, key, str_keys, true);
+    AgBTreeKey child_split_key;
+    AgBTreeNode* child_split = ag_btree_insert(in->children[c], key, str_keys, slot, inserted, &child_split_key);
+    if (*inserted)
+        in->sizes[c]++;
+    if (!child_split)
+        return NULL;
+    size_t split_size = ag_btree_node_size(child_split);
+    in->sizes[c] -= split_size;
+    if (n->count < AG_BTREE_WIDTH) {
+        ag_btree_insert_child(in, c + 1, child_split_key, child_split, split_size);
+        return NULL;
+    }
+    AgBTreeInner* right = ag_btree_alloc_inner();
+    right->node.count = AG_BTREE_WIDTH - AG_BTREE_MIN;
+    ag_memcpy(right->keys, in->keys + AG_BTREE_MIN, right->node.count * sizeof(AgBTreeKey));
+    ag_memcpy(right->children, in->children + AG_BTREE_MIN, right->node.count * sizeof(AgBTreeNode*));
+    ag_memcpy(right->sizes, in->sizes + AG_BTREE_MIN, right->node.count * sizeof(size_t));
+    n->count = AG_BTREE_MIN;
+    *split_key = right->keys[0];  // moves up, right->keys[0] becomes unused
+    if (c + 1 <= AG_BTREE_MIN)
+        ag_btree_insert_child(in, c + 1, child_split_key, child_split, split_size);
+    else
+        ag_btree_insert_child(right, c + 1 - AG_BTREE_MIN, child_split_key, child_split, split_size);
+    return &right->node;
+}
+
+AgMapVal* ag_sorted_map_insert(AgSortedMap* map, AgBTreeKey key, bool str_keys, bool* inserted) {
+    if (!map->root) {
+        map->first = ag_btree_alloc_leaf();
+        map->root = &map->first->node;
+    }
+    AgMapVal* slot;
+    AgBTreeKey split_key;
+    AgBTreeNode* split = ag_btree_insert(map->root, key, str_keys, &slot, inserted, &split_key);
+    if (split) {
+        AgBTreeInner* root = ag_btree_alloc_inner();
+        root->node.count = 2;
+        root->children[0] = map->root;
+        root->children[1] = split;
+        root->keys[1] = split_key;
+        root->sizes[1] = ag_btree_node_size(split);
+        root->sizes[0] = map->size + (*inserted ? 1 : 0) - root->sizes[1];
+        map->root = &root->node;
+    }
+    if (*inserted) {
+        map->size++;
+        map->cursor_leaf = NULL;
+    }
+    return slot;
+}
+
+//
+// Deletion
+//
+
+// Fixes underflow of child `c` of `n` by borrowing an item from a sibling or merging with it
+static void ag_btree_rebalance(AgBTreeInner* n, size_t c, bool str_keys) {
+    size_t j = c > 0 ? c - 1 : c;  // merge or rotate children j and j + 1
+    AgBTreeNode* l = n->children[j];
+    AgBTreeNode* r = n->children[j + 1];
+    if (l->count + r->count <= AG_BTREE_WIDTH) {
+        if (l->is_leaf) {
+            AgBTreeLeaf* ll = (AgBTreeLeaf*)l;
+            AgBTreeLeaf* rl = (AgBTreeLeaf*)r;
+            ag_memcpy(ll->keys + l->count, rl->keys, r->count * sizeof(AgBTreeKey));
+            ag_memcpy(ll->vals + l->count, rl->vals, r->count * sizeof(AgMapVal));
+            ll->next = rl->next;
+            if (rl->next)
+                rl->next->prev = ll;
+            ag_btree_release_key(n->keys[j + 1], str_keys);
+        } else {
+            AgBTreeInner* li = (AgBTreeInner*)l;
+            AgBTreeInner* ri = (AgBTreeInner*)r;
+            ri->keys[0] = n->keys[j + 1];  // separator moves down
+            ag_memcpy(li->keys + l->count, ri->keys, r->count * sizeof(AgBTreeKey));
+            ag_memcpy(li->children + l->count, ri->children, r->count * sizeof(AgBTreeNode*));
+            ag_memcpy(li->sizes + l->count, ri->sizes, r->count * sizeof(size_t));
+        }
+        l->count += r->count;
+        ag_free(r);
+        n->sizes[j] += n->sizes[j + 1];
+        size_t tail = n->node.count - j - 2;
+        ag_memmove(n->keys + j + 1, n->keys + j + 2, tail * sizeof(AgBTreeKey));
+        ag_memmove(n->children + j + 1, n->children + j + 2, tail * sizeof(AgBTreeNode*));
+        ag_memmove(n->sizes + j + 1, n->sizes + j + 2, tail * sizeof(size_t));
+        n->node.count--;
+        return;
+    }
+    size_t moved;
+    if (l->is_leaf) {
+        AgBTreeLeaf* ll = (AgBTreeLeaf*)l;
+        AgBTreeLeaf* rl = (AgBTreeLeaf*)r;
+        if (j == c) {  // left got underflow, take first of right
+            ll->keys[l->count] = rl->keys[0];
+            ll->vals[l->count] = rl->vals[0];
+            ag_memmove(rl->keys, rl->keys + 1, (r->count - 1) * sizeof(AgBTreeKey));
+            ag_memmove(rl->vals, rl->vals + 1, (r->count - 1) * sizeof(AgMapVal));
+        } else {  // take last of left
+            ag_memmove(rl->keys + 1, rl->keys, r->count * sizeof(AgBTreeKey));
+            ag_memmove(rl->vals + 1, rl->vals, r->count * sizeof(AgMapVal));
+            rl->keys[0] = ll->keys[l->count - 1];
+            rl->vals[0] = ll->vals[l->count - 1];
+        }
+        ag_btree_release_key(n->keys[j + 1], str_keys);
+        n->keys[j + 1] = rl->keys[0];
+        ag_btree_retain_key(n->keys[j + 1], str_keys);
+        moved = 1;
+    } else {
+        AgBTreeInner* li = (AgBTreeInner*)l;
+        AgBTreeInner* ri = (AgBTreeInner*)r;
+        if (j == c) {
+            li->keys[l->count] = n->keys[j + 1];
+            li->children[l->count] = ri->children[0];
+            li->sizes[l->count] = moved = ri->sizes[0];
+            n->keys[j + 1] = ri->keys[1];
+            ag_memmove(ri->keys + 1, ri->keys + 2, (r->count - 2) * sizeof(AgBTreeKey));
+            ag_memmove(ri->children, ri->children + 1, (r->count - 1) * sizeof(AgBTreeNode*));
+            ag_memmove(ri->sizes, ri->sizes + 1, (r->count - 1) * sizeof(size_t));
+        } else {
+            ag_memmove(ri->keys + 2, ri->keys + 1, (r->count - 1) * sizeof(AgBTreeKey));
+            ag_memmove(ri->children + 1, ri->children, r->count * sizeof(AgBTreeNode*));
+            ag_memmove(ri->sizes + 1, ri->sizes, r->count * sizeof(size_t));
+            ri->keys[1] = n->keys[j + 1];
+            ri->children[0] = li->children[l->count - 1];
+            ri->sizes[0] = moved = li->sizes[l->count - 1];
+            n->keys[j + 1] = li->keys[l->count - 1];
+        }
+    }
+    if (j == c) {
+        l->count++;
+        r->count--;
+        n->sizes[j] += moved;
+        n->sizes[j + 1] -= moved;
+    } else {
+        l->count--;
+        r->count++;
+        n->sizes[j] -= moved;
+        n->sizes[j + 1] += moved;
+    }
+}
+
+// Deletes item by key if `by_rank` is false, or by `rank` otherwise. Returns false if not found.
+static bool ag_btree_delete(
+    AgBTreeNode* n,
+    AgBTreeKey key,
+    size_t rank,
+    bool by_rank,
+    bool str_keys,
+    AgMapVal* removed)
+{
+    if (n->is_leaf) {
+        AgBTreeLeaf* leaf = (AgBTreeLeaf*)n;
+        size_t i = rank;
+        if (!by_rank) {
+            i = ag_btree_leaf_bound(leaf, key, str_keys, false);
+            if (i == n->count || ag_btree_less(key, leaf->keys[i], str_keys))
+                return false;
+        }
+        ag_btree_release_key(leaf->keys[i], str_keys);
+        *removed = leaf->vals[i];
+        size_t tail = n->count - i - 1;
+        ag_memmove(leaf->keys + i, leaf->keys + i + 1, tail * sizeof(AgBTreeKey));
+        ag_memmove(leaf->vals + i, leaf->vals + i + 1, tail * sizeof(AgMapVal));
+        n->count--;
+        return true;
+    }
+    AgBTreeInner* in = (AgBTreeInner*)n;
+    size_t c = 0;
+    if (by_rank) {
+        for (; rank >= in->sizes[c]; c++)
+            rank -= in->sizes[c];
+    } else {
+        c = ag_btree_child_index(in, key, str_keys, true);
+    }
+    if (!ag_btree_delete(in->children[c], key, rank, by_rank, str_keys, removed))
+        return false;
+    in->sizes[c]--;
+    if (in->children[c]->count < AG_BTREE_MIN)
+        ag_btree_rebalance(in, c, str_keys);
+    return true;
+}
+
+static bool ag_sorted_map_delete_impl(
+    AgSortedMap* map,
+    AgBTreeKey key,
+    size_t rank,
+    bool by_rank,
+    bool str_keys,
+    AgMapVal* removed)
+{
+    if (!map->root || !ag_btree_delete(map->root, key, rank, by_rank, str_keys, removed))
+        return false;
+    map->size--;
+    map->cursor_leaf = NULL;
+    AgBTreeNode* root = map->root;
+    if (root->is_leaf) {
+        if (!root->count) {
+            ag_free(root);
+            map->root = NULL;
+            map->first = NULL;
+        }
+    } else if (root->count == 1) {
+        map->root = ((AgBTreeInner*)root)->children[0];
+        ag_free(root);
+    }
+    return true;
+}
+
+bool ag_sorted_map_delete(AgSortedMap* map, AgBTreeKey key, bool str_keys, AgMapVal* removed) {
+    return ag_sorted_map_delete_impl(map, key, 0, false, str_keys, removed);
+}
+
+bool ag_sorted_map_delete_at(AgSortedMap* map, uint64_t rank, bool str_keys, AgMapVal* removed) {
+    return rank < map->size &&
+        ag_sorted_map_delete_impl(map, (AgBTreeKey){ 0 }, rank, true, str_keys, removed);
+}
+
+//
+// Whole tree operations
+//
+
+static void ag_btree_free(AgBTreeNode* n, bool str_keys, void(*val_disposer)(AgMapVal)) {
+    if (n->is_leaf) {
+        AgBTreeLeaf* leaf = (AgBTreeLeaf*)n;
+        for (size_t i = 0; i < n->count; i++) {
+            ag_btree_release_key(leaf->keys[i], str_keys);
+            if (val_disposer)
+                val_disposer(leaf->vals[i]);
+        }
+    } else {
+        AgBTreeInner* in = (AgBTreeInner*)n;
+        for (size_t i = 0; i < n->count; i++) {
+            if (i > 0)
+                ag_btree_release_key(in->keys[i], str_keys);
+            ag_btree_free(in->children[i], str_keys, val_disposer);
+        }
+    }
+    ag_free(n);
+}
+
+void ag_sorted_map_clear(AgSortedMap* map, bool str_keys, void(*val_disposer)(AgMapVal)) {
+    if (!map->root)
+        return;
+    AgBTreeNode* root = map->root;
+    map->root = NULL;
+    map->first = NULL;
+    map->cursor_leaf = NULL;
+    map->size = 0;
+    ag_btree_free(root, str_keys, val_disposer);
+}
+
+static AgBTreeNode* ag_btree_copy(AgBTreeNode* s, bool str_keys, AgBTreeLeaf** last_leaf) {
+    if (s->is_leaf) {
+        AgBTreeLeaf* d = ag_alloc(sizeof(AgBTreeLeaf));
+        ag_memcpy(d, s, sizeof(AgBTreeLeaf));
+        for (size_t i = 0; i < s->count; i++)
+            ag_btree_retain_key(d->keys[i], str_keys);
+        d->prev = *last_leaf;
+        d->next = NULL;
+        if (*last_leaf)
+            (*last_leaf)->next = d;
+        *last_leaf = d;
+        return &d->node;
+    }
+    AgBTreeInner* d = ag_alloc(sizeof(AgBTreeInner));
+    ag_memcpy(d, s, sizeof(AgBTreeInner));
+    for (size_t i = 0; i < s->count; i++) {
+        if (i > 0)
+            ag_btree_retain_key(d->keys[i], str_keys);
+        d->children[i] = ag_btree_copy(d->children[i], str_keys, last_leaf);
+    }
+    return &d->node;
+}
+
+void ag_sorted_map_copy(AgSortedMap* dst, AgSortedMap* src, bool str_keys) {
+    dst->size = src->size;
+    dst->cursor_leaf = NULL;
+    dst->first = NULL;
+    dst->root = NULL;
+    if (!src->root)
+        return;
+    AgBTreeLeaf* last_leaf = NULL;
+    dst->root = ag_btree_copy(src->root, str_keys, &last_leaf);
+    AgBTreeNode* n = dst->root;
+    while (!n->is_leaf)
+        n = ((AgBTreeInner*)n)->children[0];
+    dst->first = (AgBTreeLeaf*)n;
+}
@@ -0,0 +1,120 @@
+#ifndef AK_SORTED_MAP_BASE_H_
+#define AK_SORTED_MAP_BASE_H_
+
+// Declarations used by all SortedMap and SortedSet types
+//
+// B+tree with wide nodes: items live in doubly linked leaves, inner nodes hold
+// separator keys, child pointers and item counts of child subtrees.
+// Subtree counts make items addressable by rank (position in sorted order),
+// so iteration and ranges use plain int indexes like arrays.
+// Sequential rank access is served from a cached leaf position in O(1).
+// Keys are either inline int64 or shared Strings ordered bytewise.
+//
+
+#include "map-base.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AG_BTREE_WIDTH 32  // max items in leaf and max children in inner node
+
+typedef union {
+    int64_t   i;
+    AgString* s;  // shared
+} AgBTreeKey;
+
+typedef struct {
+    uint32_t count;    // items in leaf or children in inner node
+    uint32_t is_leaf;
+} AgBTreeNode;
+
+typedef struct AgBTreeLeaf {
+    AgBTreeNode         node;
+    struct AgBTreeLeaf* prev;
+    struct AgBTreeLeaf* next;
+    AgBTreeKey          keys[AG_BTREE_WIDTH];
+    AgMapVal            vals[AG_BTREE_WIDTH];  // unused in sets
+} AgBTreeLeaf;
+
+typedef struct {
+    AgBTreeNode  node;
+    AgBTreeKey   keys[AG_BTREE_WIDTH];  // keys[i] is the lowest key in children[i], keys[0] is unused
+    AgBTreeNode* children[AG_BTREE_WIDTH];
+    size_t       sizes[AG_BTREE_WIDTH];  // item counts of children subtrees
+} AgBTreeInner;
+
+typedef struct {
+    AgObject     head;
+    AgBTreeNode* root;
+    AgBTreeLeaf* first;
+    size_t       size;
+    AgBTreeLeaf* cursor_leaf;  // leaf of the last accessed rank, 0 - reset by every insert and delete, unused in shared maps
+    size_t       cursor_index;
+    size_t       cursor_rank;
+} AgSortedMap;
+
+// Returns pointer to the value of the key or 0 if not found
+AgMapVal* ag_sorted_map_find(
+    AgSortedMap* map,
+    AgBTreeKey key,
+    bool str_keys);
+
+// Returns pointer to the value of the key, allocates a new item if key is not in the map.
+// New items have zero `val`. Pointer is valid till the next insert or delete.
+AgMapVal* ag_sorted_map_insert(
+    AgSortedMap* map,
+    AgBTreeKey key,
+    bool str_keys,
+    bool* inserted);
+
+// Returns false if not found
+bool ag_sorted_map_delete(
+    AgSortedMap* map,
+    AgBTreeKey key,
+    bool str_keys,
+    AgMapVal* removed);
+
+// Returns false if rank >= size
+bool ag_sorted_map_delete_at(
+    AgSortedMap* map,
+    uint64_t rank,
+    bool str_keys,
+    AgMapVal* removed);
+
+// Returns rank of the first item with key >= `key` (or > `key` if `upper`)
+size_t ag_sorted_map_bound(
+    AgSortedMap* map,
+    AgBTreeKey key,
+    bool str_keys,
+    bool upper);
+
+// Returns leaf holding item at rank and its index in `*index`, or 0 if rank >= size
+AgBTreeLeaf* ag_sorted_map_at(
+    AgSortedMap* map,
+    uint64_t rank,
+    size_t* index);
+
+void ag_sorted_map_clear(
+    AgSortedMap* map,
+    bool str_keys,
+    void(*val_disposer)(AgMapVal));
+
+// Makes a structural copy of `src` tree in `dst`, retains keys but not values
+void ag_sorted_map_copy(
+    AgSortedMap* dst,
+    AgSortedMap* src,
+    bool str_keys);
+
+#define AG_SORTED_MAP_FOR_EACH(MAP, VAL_ACTION)                                   \
+    for (AgBTreeLeaf* l = (MAP)->first; l; l = l->next) {                         \
+        for (AgMapVal* v = l->vals, *term = v + l->node.count; v < term; v++) {   \
+            VAL_ACTION;                                                           \
+        }                                                                         \
+    }
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif // AK_SORTED_MAP_BASE_H_
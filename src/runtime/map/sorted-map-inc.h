@@ -0,0 +1,137 @@
+// Instantiated in sorted-map.c for every key and value kind.
+// Expects:
+//   AG_NAME(PREFIX, SUFFIX) - makes a function name,
+//   AG_SM_KEY_T, AG_SM_STR - key type and its kind (0 - int, 1 - String),
+//   AG_SM_KEY(K) - makes AgBTreeKey, AG_SM_KEY_AT(K) - returns retained key from AgBTreeKey,
+//   AG_SM_SET - 1 for sets, 0 for maps.
+// Maps also expect:
+//   AG_SM_VAL_T, AG_SM_VAL_FIELD - value type and AgMapVal field,
+//   AG_SM_STORE(V, MAP), AG_SM_RETAIN(V), AG_SM_DETACH(V), AG_SM_DISPOSE(V) - value ownership,
+//   AG_SM_COPY_VAL(SLOT, MAP) - copies value in AgMapVal* SLOT of a just copied MAP,
+//   AG_SM_VISIT_KIND.
+
+int64_t AG_NAME(ag_m_sys_, _size)(AgSortedMap* map) {
+    return map->size;
+}
+
+int64_t AG_NAME(ag_m_sys_, _lowerBound)(AgSortedMap* map, AG_SM_KEY_T key) {
+    return ag_sorted_map_bound(map, AG_SM_KEY(key), AG_SM_STR, false);
+}
+
+int64_t AG_NAME(ag_m_sys_, _upperBound)(AgSortedMap* map, AG_SM_KEY_T key) {
+    return ag_sorted_map_bound(map, AG_SM_KEY(key), AG_SM_STR, true);
+}
+
+AG_SM_KEY_T AG_NAME(ag_m_sys_, _keyAt)(AgSortedMap* map, uint64_t rank) {
+    size_t i;
+    AgBTreeLeaf* leaf = ag_sorted_map_at(map, rank, &i);
+    return leaf ? AG_SM_KEY_AT(leaf->keys[i]) : 0;
+}
+
+#if AG_SM_SET
+
+void AG_NAME(ag_m_sys_, _clear)(AgSortedMap* set) {
+    ag_sorted_map_clear(set, AG_SM_STR, NULL);
+}
+
+bool AG_NAME(ag_m_sys_, _contains)(AgSortedMap* set, AG_SM_KEY_T key) {
+    return ag_sorted_map_find(set, AG_SM_KEY(key), AG_SM_STR) != NULL;
+}
+
+bool AG_NAME(ag_m_sys_, _add)(AgSortedMap* set, AG_SM_KEY_T key) {
+    bool inserted;
+    ag_sorted_map_insert(set, AG_SM_KEY(key), AG_SM_STR, &inserted);
+    return inserted;
+}
+
+bool AG_NAME(ag_m_sys_, _delete)(AgSortedMap* set, AG_SM_KEY_T key) {
+    AgMapVal removed;
+    return ag_sorted_map_delete(set, AG_SM_KEY(key), AG_SM_STR, &removed);
+}
+
+void AG_NAME(ag_m_sys_, _removeAt)(AgSortedMap* set, uint64_t rank) {
+    AgMapVal removed;
+    ag_sorted_map_delete_at(set, rank, AG_SM_STR, &removed);
+}
+
+void AG_NAME(ag_copy_sys_, )(void* dst, void* src) {
+    ag_sorted_map_copy((AgSortedMap*)dst, (AgSortedMap*)src, AG_SM_STR);
+}
+
+void AG_NAME(ag_visit_sys_, )(
+    AgSortedMap* set,
+    void      (*visitor)(void*, int, void*),
+    void*       ctx)
+{}
+
+#else
+
+static void AG_NAME(ag_dispose_, _val)(AgMapVal v) {
+    AG_SM_DISPOSE(v.AG_SM_VAL_FIELD);
+}
+
+void AG_NAME(ag_m_sys_, _clear)(AgSortedMap* map) {
+    ag_sorted_map_clear(map, AG_SM_STR, AG_NAME(ag_dispose_, _val));
+}
+
+AG_SM_VAL_T AG_NAME(ag_m_sys_, _getAt)(AgSortedMap* map, AG_SM_KEY_T key) {
+    AgMapVal* v = ag_sorted_map_find(map, AG_SM_KEY(key), AG_SM_STR);
+    if (!v)
+        return 0;
+    AG_SM_RETAIN(v->AG_SM_VAL_FIELD);
+    return v->AG_SM_VAL_FIELD;
+}
+
+AG_SM_VAL_T AG_NAME(ag_m_sys_, _setAt)(AgSortedMap* map, AG_SM_KEY_T key, AG_SM_VAL_T value) {
+    AG_SM_STORE(value, map);
+    bool inserted;
+    AgMapVal* v = ag_sorted_map_insert(map, AG_SM_KEY(key), AG_SM_STR, &inserted);
+    AG_SM_VAL_T r = v->AG_SM_VAL_FIELD;
+    v->AG_SM_VAL_FIELD = value;
+    AG_SM_DETACH(r);
+    return r;
+}
+
+AG_SM_VAL_T AG_NAME(ag_m_sys_, _delete)(AgSortedMap* map, AG_SM_KEY_T key) {
+    AgMapVal removed;
+    if (!ag_sorted_map_delete(map, AG_SM_KEY(key), AG_SM_STR, &removed))
+        return 0;
+    AG_SM_DETACH(removed.AG_SM_VAL_FIELD);
+    return removed.AG_SM_VAL_FIELD;
+}
+
+AG_SM_VAL_T AG_NAME(ag_m_sys_, _valAt)(AgSortedMap* map, uint64_t rank) {
+    size_t i;
+    AgBTreeLeaf* leaf = ag_sorted_map_at(map, rank, &i);
+    if (!leaf)
+        return 0;
+    AG_SM_RETAIN(leaf->vals[i].AG_SM_VAL_FIELD);
+    return leaf->vals[i].AG_SM_VAL_FIELD;
+}
+
+void AG_NAME(ag_m_sys_, _removeAt)(AgSortedMap* map, uint64_t rank) {
+    AgMapVal removed;
+    if (ag_sorted_map_delete_at(map, rank, AG_SM_STR, &removed))
+        AG_NAME(ag_dispose_, _val)(removed);
+}
+
+void AG_NAME(ag_copy_sys_, )(void* dst, void* src) {
+    AgSortedMap* d = (AgSortedMap*)dst;
+    ag_sorted_map_copy(d, (AgSortedMap*)src, AG_SM_STR);
+    AG_SORTED_MAP_FOR_EACH(d, AG_SM_COPY_VAL(v, d))
+}
+
+void AG_NAME(ag_visit_sys_, )(
+    AgSortedMap* map,
+    void      (*visitor)(void*, int, void*),
+    void*       ctx)
+{
+    if (ag_not_null(map))
+        AG_SORTED_MAP_FOR_EACH(map, if (v->AG_SM_VAL_FIELD) visitor(&v->AG_SM_VAL_FIELD, AG_SM_VISIT_KIND, ctx))
+}
+
+#endif
+
+void AG_NAME(ag_dtor_sys_, )(void* map) {
+    AG_NAME(ag_m_sys_, _clear)((AgSortedMap*)map);
+}
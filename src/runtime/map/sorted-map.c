@@ -0,0 +1,168 @@
+#include "sorted-map.h"
+
+#define AG_SM_INT_KEY(K) ((AgBTreeKey){ .i = (K) })
+#define AG_SM_INT_KEY_AT(K) ((K).i)
+#define AG_SM_STR_KEY(K) ((AgBTreeKey){ .s = (K) })
+#define AG_SM_STR_KEY_AT(K) (ag_retain_shared(&(K).s->head), (K).s)
+
+//
+// Own values
+//
+#define AG_SM_SET 0
+#define AG_SM_VAL_T AgObject*
+#define AG_SM_VAL_FIELD ptr_val
+#define AG_SM_STORE(V, MAP) ag_retain_own(V, &(MAP)->head)
+#define AG_SM_RETAIN(V) ag_retain_pin(V)
+#define AG_SM_DETACH(V) ag_set_parent(V, NULL)
+#define AG_SM_DISPOSE(V) ag_release_own(V)
+#define AG_SM_COPY_VAL(SLOT, MAP) (SLOT)->ptr_val = ag_copy_object_field((SLOT)->ptr_val, &(MAP)->head)
+#define AG_SM_VISIT_KIND AG_VISIT_OWN
+
+#define AG_NAME(PREFIX, SUFFIX) PREFIX##SortedIntMap##SUFFIX
+#define AG_SM_KEY_T int64_t
+#define AG_SM_STR 0
+#define AG_SM_KEY AG_SM_INT_KEY
+#define AG_SM_KEY_AT AG_SM_INT_KEY_AT
+#include "sorted-map-inc.h"
+#undef AG_NAME
+#undef AG_SM_KEY_T
+#undef AG_SM_STR
+#undef AG_SM_KEY
+#undef AG_SM_KEY_AT
+
+#define AG_NAME(PREFIX, SUFFIX) PREFIX##SortedStrMap##SUFFIX
+#define AG_SM_KEY_T AgString*
+#define AG_SM_STR 1
+#define AG_SM_KEY AG_SM_STR_KEY
+#define AG_SM_KEY_AT AG_SM_STR_KEY_AT
+#include "sorted-map-inc.h"
+#undef AG_NAME
+#undef AG_SM_KEY_T
+#undef AG_SM_STR
+#undef AG_SM_KEY
+#undef AG_SM_KEY_AT
+
+#undef AG_SM_STORE
+#undef AG_SM_RETAIN
+#undef AG_SM_DETACH
+#undef AG_SM_DISPOSE
+#undef AG_SM_COPY_VAL
+
+//
+// Shared values
+//
+#define AG_SM_STORE(V, MAP) ag_retain_shared(V)
+#define AG_SM_RETAIN(V) ag_retain_shared(V)
+#define AG_SM_DETACH(V) (void)(V)
+#define AG_SM_DISPOSE(V) ag_release_shared(V)
+#define AG_SM_COPY_VAL(SLOT, MAP) ag_retain_shared((SLOT)->ptr_val)
+
+#define AG_NAME(PREFIX, SUFFIX) PREFIX##SharedSortedIntMap##SUFFIX
+#define AG_SM_KEY_T int64_t
+#define AG_SM_STR 0
+#define AG_SM_KEY AG_SM_INT_KEY
+#define AG_SM_KEY_AT AG_SM_INT_KEY_AT
+#include "sorted-map-inc.h"
+#undef AG_NAME
+#undef AG_SM_KEY_T
+#undef AG_SM_STR
+#undef AG_SM_KEY
+#undef AG_SM_KEY_AT
+
+#define AG_NAME(PREFIX, SUFFIX) PREFIX##SharedSortedStrMap##SUFFIX
+#define AG_SM_KEY_T AgString*
+#define AG_SM_STR 1
+#define AG_SM_KEY AG_SM_STR_KEY
+#define AG_SM_KEY_AT AG_SM_STR_KEY_AT
+#include "sorted-map-inc.h"
+#undef AG_NAME
+#undef AG_SM_KEY_T
+#undef AG_SM_STR
+#undef AG_SM_KEY
+#undef AG_SM_KEY_AT
+
+#undef AG_SM_VAL_T
+#undef AG_SM_VAL_FIELD
+#undef AG_SM_STORE
+#undef AG_SM_RETAIN
+#undef AG_SM_DETACH
+#undef AG_SM_DISPOSE
+#undef AG_SM_COPY_VAL
+#undef AG_SM_VISIT_KIND
+
+//
+// Weak values
+//
+#define AG_SM_VAL_T AgWeak*
+#define AG_SM_VAL_FIELD weak_val
+#define AG_SM_STORE(V, MAP) ag_retain_weak(V)
+#define AG_SM_RETAIN(V) ag_retain_weak(V)
+#define AG_SM_DETACH(V) (void)(V)
+#define AG_SM_DISPOSE(V) ag_release_weak(V)
+#define AG_SM_COPY_VAL(SLOT, MAP) ag_copy_weak_field((void**)&(SLOT)->weak_val, (SLOT)->weak_val)
+#define AG_SM_VISIT_KIND AG_VISIT_WEAK
+
+#define AG_NAME(PREFIX, SUFFIX) PREFIX##WeakSortedIntMap##SUFFIX
+#define AG_SM_KEY_T int64_t
+#define AG_SM_STR 0
+#define AG_SM_KEY AG_SM_INT_KEY
+#define AG_SM_KEY_AT AG_SM_INT_KEY_AT
+#include "sorted-map-inc.h"
+#undef AG_NAME
+#undef AG_SM_KEY_T
+#undef AG_SM_STR
+#undef AG_SM_KEY
+#undef AG_SM_KEY_AT
+
+#define AG_NAME(PREFIX, SUFFIX) PREFIX##WeakSortedStrMap##SUFFIX
+#define AG_SM_KEY_T AgString*
+#define AG_SM_STR 1
+#define AG_SM_KEY AG_SM_STR_KEY
+#define AG_SM_KEY_AT AG_SM_STR_KEY_AT
+#include "sorted-map-inc.h"
+#undef AG_NAME
+#undef AG_SM_KEY_T
+#undef AG_SM_STR
+#undef AG_SM_KEY
+#undef AG_SM_KEY_AT
+
+#undef AG_SM_SET
+#undef AG_SM_VAL_T
+#undef AG_SM_VAL_FIELD
+#undef AG_SM_STORE
+#undef AG_SM_RETAIN
+#undef AG_SM_DETACH
+#undef AG_SM_DISPOSE
+#undef AG_SM_COPY_VAL
+#undef AG_SM_VISIT_KIND
+
+//
+// Sets
+//
+#define AG_SM_SET 1
+
+#define AG_NAME(PREFIX, SUFFIX) PREFIX##SortedIntSet##SUFFIX
+#define AG_SM_KEY_T int64_t
+#define AG_SM_STR 0
+#define AG_SM_KEY AG_SM_INT_KEY
+#define AG_SM_KEY_AT AG_SM_INT_KEY_AT
+#include "sorted-map-inc.h"
+#undef AG_NAME
+#undef AG_SM_KEY_T
+#undef AG_SM_STR
+#undef AG_SM_KEY
+#undef AG_SM_KEY_AT
+
+#define AG_NAME(PREFIX, SUFFIX) PREFIX##SortedStrSet##SUFFIX
+#define AG_SM_KEY_T AgString*
+#define AG_SM_STR 1
+#define AG_SM_KEY AG_SM_STR_KEY
+#define AG_SM_KEY_AT AG_SM_STR_KEY_AT
+#include "sorted-map-inc.h"
+#undef AG_NAME
+#undef AG_SM_KEY_T
+#undef AG_SM_STR
+#undef AG_SM_KEY
+#undef AG_SM_KEY_AT
+
+#undef AG_SM_SET
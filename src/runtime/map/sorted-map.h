@@ -0,0 +1,57 @@
+#ifndef AK_SORTED_MAP_H_
+#define AK_SORTED_MAP_H_
+
+#include "sorted-map-base.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Items are addressed by rank: 0..size-1 in key order.
+// keyAt/valAt/removeAt with ranks going up or down by one don't search the tree.
+#define AG_SORTED_MAP_DECLS(NAME, KEY_T, VAL_T)                                                         \
+    int64_t ag_m_sys_##NAME##_size      (AgSortedMap* map);                                            \
+    void    ag_m_sys_##NAME##_clear     (AgSortedMap* map);                                            \
+    VAL_T   ag_m_sys_##NAME##_getAt     (AgSortedMap* map, KEY_T key);                                 \
+    VAL_T   ag_m_sys_##NAME##_setAt     (AgSortedMap* map, KEY_T key, VAL_T value);  /* returns previous value */ \
+    VAL_T   ag_m_sys_##NAME##_delete    (AgSortedMap* map, KEY_T key);               /* returns previous value */ \
+    int64_t ag_m_sys_##NAME##_lowerBound(AgSortedMap* map, KEY_T key);  /* rank of the first key >= `key` */ \
+    int64_t ag_m_sys_##NAME##_upperBound(AgSortedMap* map, KEY_T key);  /* rank of the first key > `key` */  \
+    KEY_T   ag_m_sys_##NAME##_keyAt     (AgSortedMap* map, uint64_t rank);                             \
+    VAL_T   ag_m_sys_##NAME##_valAt     (AgSortedMap* map, uint64_t rank);                             \
+    void    ag_m_sys_##NAME##_removeAt  (AgSortedMap* map, uint64_t rank);                             \
+    void    ag_copy_sys_##NAME          (void* dst, void* src);                                        \
+    void    ag_dtor_sys_##NAME          (void* map);                                                   \
+    void    ag_visit_sys_##NAME         (AgSortedMap* map, void(*visitor)(void*, int, void*), void* ctx);
+
+#define AG_SORTED_SET_DECLS(NAME, KEY_T)                                                                \
+    int64_t ag_m_sys_##NAME##_size      (AgSortedMap* set);                                            \
+    void    ag_m_sys_##NAME##_clear     (AgSortedMap* set);                                            \
+    bool    ag_m_sys_##NAME##_contains  (AgSortedMap* set, KEY_T key);                                 \
+    bool    ag_m_sys_##NAME##_add       (AgSortedMap* set, KEY_T key);  /* returns true if key was not in set */ \
+    bool    ag_m_sys_##NAME##_delete    (AgSortedMap* set, KEY_T key);  /* returns true if key was in set */     \
+    int64_t ag_m_sys_##NAME##_lowerBound(AgSortedMap* set, KEY_T key);                                 \
+    int64_t ag_m_sys_##NAME##_upperBound(AgSortedMap* set, KEY_T key);                                 \
+    KEY_T   ag_m_sys_##NAME##_keyAt     (AgSortedMap* set, uint64_t rank);                             \
+    void    ag_m_sys_##NAME##_removeAt  (AgSortedMap* set, uint64_t rank);                             \
+    void    ag_copy_sys_##NAME          (void* dst, void* src);                                        \
+    void    ag_dtor_sys_##NAME          (void* set);                                                   \
+    void    ag_visit_sys_##NAME         (AgSortedMap* set, void(*visitor)(void*, int, void*), void* ctx);
+
+AG_SORTED_MAP_DECLS(SortedIntMap, int64_t, AgObject*)
+AG_SORTED_MAP_DECLS(SharedSortedIntMap, int64_t, AgObject*)
+AG_SORTED_MAP_DECLS(WeakSortedIntMap, int64_t, AgWeak*)
+AG_SORTED_SET_DECLS(SortedIntSet, int64_t)
+AG_SORTED_MAP_DECLS(SortedStrMap, AgString*, AgObject*)
+AG_SORTED_MAP_DECLS(SharedSortedStrMap, AgString*, AgObject*)
+AG_SORTED_MAP_DECLS(WeakSortedStrMap, AgString*, AgWeak*)
+AG_SORTED_SET_DECLS(SortedStrSet, AgString*)
+
+#undef AG_SORTED_MAP_DECLS
+#undef AG_SORTED_SET_DECLS
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif // AK_SORTED_MAP_H_
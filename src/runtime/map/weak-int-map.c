@@ -0,0 +1,85 @@
+#include "weak-int-map.h"
+
+int64_t ag_m_sys_WeakIntMap_size(AgIntMap* map) {
+    return map->size;
+}
+
+int64_t ag_m_sys_WeakIntMap_capacity(AgIntMap* map) {
+    return map->capacity;
+}
+
+static void val_weak_diposer(AgMapVal v) {
+    ag_release_weak(v.weak_val);
+}
+
+void ag_m_sys_WeakIntMap_clear(AgIntMap* map) {
+    ag_int_map_clear(map, val_weak_diposer);
+}
+
+AgWeak* ag_m_sys_WeakIntMap_getAt(AgIntMap* map, int64_t key) {
+    size_t i = ag_int_map_find_index(map, key);
+    if (i == AG_MAP_NOT_FOUND)
+        return 0;
+    AgWeak* r = map->buckets[i].val.weak_val;
+    ag_retain_weak(r);
+    return r;
+}
+
+AgWeak* ag_m_sys_WeakIntMap_setAt(AgIntMap* map, int64_t key, AgWeak* value) {
+    ag_retain_weak(value);
+    bool inserted;
+    size_t i = ag_int_map_insert(map, key, &inserted);
+    AgIntMapBucket* b = map->buckets + i;
+    AgWeak* r = b->val.weak_val;
+    b->val.weak_val = value;
+    return r;
+}
+
+AgWeak* ag_m_sys_WeakIntMap_delete(AgIntMap* map, int64_t key) {
+    AgWeak* r = ag_int_map_delete_at(map, ag_int_map_find_index(map, key)).weak_val;
+    return r;
+}
+
+void ag_m_sys_WeakIntMap_reserve(AgIntMap* map, uint64_t size) {
+    ag_int_map_reserve(map, size);
+}
+
+void ag_m_sys_WeakIntMap_shrinkToFit(AgIntMap* map) {
+    ag_int_map_shrink(map);
+}
+
+void ag_m_sys_WeakIntMap_removeAt(AgIntMap* map, uint64_t index) {
+    val_weak_diposer(ag_int_map_delete_at(map, index));
+}
+
+bool ag_m_sys_WeakIntMap_usedAt(AgIntMap* map, uint64_t index) {
+    return ag_int_map_used_at(map, index);
+}
+
+int64_t ag_m_sys_WeakIntMap_keyAt(AgIntMap* map, uint64_t index) {
+    return ag_int_map_used_at(map, index) ? map->buckets[index].key : 0;
+}
+
+AgWeak* ag_m_sys_WeakIntMap_valAt(AgIntMap* map, uint64_t index) {
+    if (!ag_int_map_used_at(map, index))
+        return 0;
+    AgWeak* r = map->buckets[index].val.weak_val;
+    ag_retain_weak(r);
+    return r;
+}
+
+void ag_copy_sys_WeakIntMap(void* dst, void* src) {
+    AG_INT_MAP_COPY(ag_copy_weak_field((void**)&i->val.weak_val, i->val.weak_val))
+}
+
+void ag_dtor_sys_WeakIntMap(void* map) {
+    ag_m_sys_WeakIntMap_clear((AgIntMap*)map);
+}
+
+void ag_visit_sys_WeakIntMap(
+    AgIntMap* map,
+    void   (*visitor)(void*, int, void*),
+    void*  ctx)
+{
+    AG_INT_MAP_VISIT(if (i->val.weak_val) visitor(&i->val.weak_val, AG_VISIT_WEAK, ctx))
+}
@@ -0,0 +1,34 @@
+#ifndef AK_WEAK_INT_MAP_H_
+#define AK_WEAK_INT_MAP_H_
+
+#include "int-map-base.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int64_t   ag_m_sys_WeakIntMap_size(AgIntMap* map);
+int64_t   ag_m_sys_WeakIntMap_capacity(AgIntMap* map);
+void      ag_m_sys_WeakIntMap_clear(AgIntMap* map);
+AgWeak*   ag_m_sys_WeakIntMap_getAt(AgIntMap* map, int64_t key);                  // returns &T
+AgWeak*   ag_m_sys_WeakIntMap_setAt(AgIntMap* map, int64_t key, AgWeak* value); // returns previous object as &T
+AgWeak*   ag_m_sys_WeakIntMap_delete(AgIntMap* map, int64_t key);                 // returns previous object as &T
+void      ag_m_sys_WeakIntMap_reserve(AgIntMap* map, uint64_t size);
+void      ag_m_sys_WeakIntMap_shrinkToFit(AgIntMap* map);
+void      ag_m_sys_WeakIntMap_removeAt(AgIntMap* map, uint64_t index);     // removes by bucket index, safe while iterating
+bool      ag_m_sys_WeakIntMap_usedAt(AgIntMap* map, uint64_t index);
+int64_t   ag_m_sys_WeakIntMap_keyAt(AgIntMap* map, uint64_t index);
+AgWeak*   ag_m_sys_WeakIntMap_valAt(AgIntMap* map, uint64_t index);
+
+void      ag_copy_sys_WeakIntMap(void* dst, void* src);
+void      ag_dtor_sys_WeakIntMap(void* map);
+void      ag_visit_sys_WeakIntMap(
+             AgIntMap* map,
+             void    (*visitor)(void*, int, void*),
+             void* ctx);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif // AK_WEAK_INT_MAP_H_
@@ -17,8 +17,8 @@ void ag_m_sys_WeakMap_clear(AgMap* map) {
 }
 
 AgWeak* ag_m_sys_WeakMap_getAt(AgMap* map, AgObject* key) {
-    size_t i = ag_map_find_index(map, key, ag_fn_sys_hash(key));
-    if (i == ~0u)
+    size_t i = ag_map_find_index(map, key, ag_map_hash(key));
+    if (i == AG_MAP_NOT_FOUND)
         return 0;
     AgWeak* r = map->buckets[i].val.weak_val;
     ag_retain_weak(r);
@@ -34,6 +34,26 @@ AgWeak* ag_m_sys_WeakMap_delete(AgMap* map, AgObject* key) {
     return ag_map_delete(map, key).weak_val;
 }
 
+void ag_m_sys_WeakMap_reserve(AgMap* map, uint64_t size) {
+    ag_map_reserve(map, size);
+}
+
+void ag_m_sys_WeakMap_shrinkToFit(AgMap* map) {
+    ag_map_shrink(map);
+}
+
+void ag_m_sys_WeakMap_removeAt(AgMap* map, uint64_t index) {
+    val_weak_diposer(ag_map_delete_at(map, index));
+}
+
+static void val_weak_retainer(AgMapVal v) {
+    ag_retain_weak(v.weak_val);
+}
+
+void ag_m_sys_WeakMap_setAll(AgMap* map, AgMap* src) {
+    ag_map_set_all(map, src, val_weak_retainer, val_weak_diposer);
+}
+
 AgObject* ag_m_sys_WeakMap_keyAt(AgMap* map, uint64_t index) {
     return ag_map_key_at(map, index);
 }
@@ -13,6 +13,10 @@ extern "C" {
     AgWeak*   ag_m_sys_WeakMap_getAt(AgMap* map, AgObject* key);                  // returns &T
     AgWeak*   ag_m_sys_WeakMap_setAt(AgMap* map, AgObject* key, AgWeak* value);   // returns previous object as &T
     AgWeak*   ag_m_sys_WeakMap_delete(AgMap* map, AgObject* key);                 // returns previous object as &T
+    void      ag_m_sys_WeakMap_reserve(AgMap* map, uint64_t size);
+    void      ag_m_sys_WeakMap_shrinkToFit(AgMap* map);
+    void      ag_m_sys_WeakMap_removeAt(AgMap* map, uint64_t index);     // removes by bucket index, safe while iterating
+    void      ag_m_sys_WeakMap_setAll(AgMap* map, AgMap* src);
     AgObject* ag_m_sys_WeakMap_keyAt(AgMap* map, uint64_t index);
     AgWeak*   ag_m_sys_WeakMap_valAt(AgMap* map, uint64_t index);
 
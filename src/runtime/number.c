@@ -0,0 +1,330 @@
+#include <stdlib.h>  // strtod
+#include <string.h>  // memcpy
+#include "number.h"
+#include "runtime.h"
+
+static const char ag_digit_pairs[] =
+	"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+	"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+int ag_format_int(int64_t v, char* buf) {
+	char tmp[AG_INT_TEXT_MAX];
+	char* p = tmp + sizeof(tmp);
+	uint64_t u = v < 0 ? 0 - (uint64_t)v : (uint64_t)v;
+	while (u >= 100) {
+		const char* pair = ag_digit_pairs + (u % 100) * 2;
+		u /= 100;
+		*--p = pair[1];
+		*--p = pair[0];
+	}
+	if (u >= 10) {
+		*--p = ag_digit_pairs[u * 2 + 1];
+		*--p = ag_digit_pairs[u * 2];
+	} else {
+		*--p = (char)('0' + u);
+	}
+	if (v < 0)
+		*--p = '-';
+	int size = (int)(tmp + sizeof(tmp) - p);
+	memcpy(buf, p, size);
+	return size;
+}
+
+//
+// Grisu2 by Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers".
+// Its output always parses back to the same double, and is the shortest one for ~99.9% of values.
+//
+typedef struct {
+	uint64_t f;
+	int      e;
+} AgDiyFp;
+
+#define AG_DBL_HIDDEN_BIT 0x0010000000000000ull
+#define AG_DBL_FRAC_MASK  0x000FFFFFFFFFFFFFull
+#define AG_DBL_EXP_MASK   0x7FF0000000000000ull
+#define AG_DBL_EXP_BIAS   1075  // 0x3FF + 52
+
+// Normalized 10^k for k = -348, -340, ..., 340
+static const AgDiyFp ag_cached_powers[] = {
+	{ 0xfa8fd5a0081c0288ull, -1220 }, { 0xbaaee17fa23ebf76ull, -1193 }, { 0x8b16fb203055ac76ull, -1166 },
+	{ 0xcf42894a5dce35eaull, -1140 }, { 0x9a6bb0aa55653b2dull, -1113 }, { 0xe61acf033d1a45dfull, -1087 },
+	{ 0xab70fe17c79ac6caull, -1060 }, { 0xff77b1fcbebcdc4full, -1034 }, { 0xbe5691ef416bd60cull, -1007 },
+	{ 0x8dd01fad907ffc3cull, -980 }, { 0xd3515c2831559a83ull, -954 }, { 0x9d71ac8fada6c9b5ull, -927 },
+	{ 0xea9c227723ee8bcbull, -901 }, { 0xaecc49914078536dull, -874 }, { 0x823c12795db6ce57ull, -847 },
+	{ 0xc21094364dfb5637ull, -821 }, { 0x9096ea6f3848984full, -794 }, { 0xd77485cb25823ac7ull, -768 },
+	{ 0xa086cfcd97bf97f4ull, -741 }, { 0xef340a98172aace5ull, -715 }, { 0xb23867fb2a35b28eull, -688 },
+	{ 0x84c8d4dfd2c63f3bull, -661 }, { 0xc5dd44271ad3cdbaull, -635 }, { 0x936b9fcebb25c996ull, -608 },
+	{ 0xdbac6c247d62a584ull, -582 }, { 0xa3ab66580d5fdaf6ull, -555 }, { 0xf3e2f893dec3f126ull, -529 },
+	{ 0xb5b5ada8aaff80b8ull, -502 }, { 0x87625f056c7c4a8bull, -475 }, { 0xc9bcff6034c13053ull, -449 },
+	{ 0x964e858c91ba2655ull, -422 }, { 0xdff9772470297ebdull, -396 }, { 0xa6dfbd9fb8e5b88full, -369 },
+	{ 0xf8a95fcf88747d94ull, -343 }, { 0xb94470938fa89bcfull, -316 }, { 0x8a08f0f8bf0f156bull, -289 },
+	{ 0xcdb02555653131b6ull, -263 }, { 0x993fe2c6d07b7facull, -236 }, { 0xe45c10c42a2b3b06ull, -210 },
+	{ 0xaa242499697392d3ull, -183 }, { 0xfd87b5f28300ca0eull, -157 }, { 0xbce5086492111aebull, -130 },
+	{ 0x8cbccc096f5088ccull, -103 }, { 0xd1b71758e219652cull, -77 }, { 0x9c40000000000000ull, -50 },
+	{ 0xe8d4a51000000000ull, -24 }, { 0xad78ebc5ac620000ull, 3 }, { 0x813f3978f8940984ull, 30 },
+	{ 0xc097ce7bc90715b3ull, 56 }, { 0x8f7e32ce7bea5c70ull, 83 }, { 0xd5d238a4abe98068ull, 109 },
+	{ 0x9f4f2726179a2245ull, 136 }, { 0xed63a231d4c4fb27ull, 162 }, { 0xb0de65388cc8ada8ull, 189 },
+	{ 0x83c7088e1aab65dbull, 216 }, { 0xc45d1df942711d9aull, 242 }, { 0x924d692ca61be758ull, 269 },
+	{ 0xda01ee641a708deaull, 295 }, { 0xa26da3999aef774aull, 322 }, { 0xf209787bb47d6b85ull, 348 },
+	{ 0xb454e4a179dd1877ull, 375 }, { 0x865b86925b9bc5c2ull, 402 }, { 0xc83553c5c8965d3dull, 428 },
+	{ 0x952ab45cfa97a0b3ull, 455 }, { 0xde469fbd99a05fe3ull, 481 }, { 0xa59bc234db398c25ull, 508 },
+	{ 0xf6c69a72a3989f5cull, 534 }, { 0xb7dcbf5354e9beceull, 561 }, { 0x88fcf317f22241e2ull, 588 },
+	{ 0xcc20ce9bd35c78a5ull, 614 }, { 0x98165af37b2153dfull, 641 }, { 0xe2a0b5dc971f303aull, 667 },
+	{ 0xa8d9d1535ce3b396ull, 694 }, { 0xfb9b7cd9a4a7443cull, 720 }, { 0xbb764c4ca7a44410ull, 747 },
+	{ 0x8bab8eefb6409c1aull, 774 }, { 0xd01fef10a657842cull, 800 }, { 0x9b10a4e5e9913129ull, 827 },
+	{ 0xe7109bfba19c0c9dull, 853 }, { 0xac2820d9623bf429ull, 880 }, { 0x80444b5e7aa7cf85ull, 907 },
+	{ 0xbf21e44003acdd2dull, 933 }, { 0x8e679c2f5e44ff8full, 960 }, { 0xd433179d9c8cb841ull, 986 },
+	{ 0x9e19db92b4e31ba9ull, 1013 }, { 0xeb96bf6ebadf77d9ull, 1039 }, { 0xaf87023b9bf0ee6bull, 1066 },
+};
+
+static const uint64_t ag_pow10_u64[] = {
+	1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull, 1000000000ull,
+	10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull, 100000000000000ull,
+	1000000000000000ull, 10000000000000000ull, 100000000000000000ull, 1000000000000000000ull,
+	10000000000000000000ull
+};
+
+static AgDiyFp ag_diy_mul(AgDiyFp x, AgDiyFp y) {
+	const uint64_t m32 = 0xFFFFFFFFull;
+	uint64_t a = x.f >> 32, b = x.f & m32;
+	uint64_t c = y.f >> 32, d = y.f & m32;
+	uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+	uint64_t tmp = (bd >> 32) + (ad & m32) + (bc & m32) + (1ull << 31);  // rounds the lower half
+	AgDiyFp r = { ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), x.e + y.e + 64 };
+	return r;
+}
+
+static AgDiyFp ag_diy_normalize(AgDiyFp v) {
+	while (!(v.f & (1ull << 63))) {
+		v.f <<= 1;
+		v.e--;
+	}
+	return v;
+}
+
+static int ag_count_digits32(uint32_t n) {
+	int r = 1;
+	while (r < 10 && n >= ag_pow10_u64[r])
+		r++;
+	return r;
+}
+
+static void ag_grisu_round(char* buf, int len, uint64_t delta, uint64_t rest, uint64_t ten_kappa, uint64_t wp_w) {
+	while (rest < wp_w && delta - rest >= ten_kappa &&
+		(rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w))
+	{
+		buf[len - 1]--;
+		rest += ten_kappa;
+	}
+}
+
+// Generates digits of `w` in [w-delta, mp], `*k` - decimal exponent of the last digit
+static int ag_grisu_digits(AgDiyFp w, AgDiyFp mp, uint64_t delta, char* buf, int* k) {
+	AgDiyFp one = { 1ull << -mp.e, mp.e };
+	uint64_t wp_w = mp.f - w.f;
+	uint32_t p1 = (uint32_t)(mp.f >> -one.e);
+	uint64_t p2 = mp.f & (one.f - 1);
+	int len = 0;
+	for (int kappa = ag_count_digits32(p1); kappa > 0;) {
+		uint32_t div = (uint32_t)ag_pow10_u64[--kappa];
+		uint32_t d = p1 / div;
+		p1 %= div;
+		if (d || len)
+			buf[len++] = (char)('0' + d);
+		uint64_t rest = ((uint64_t)p1 << -one.e) + p2;
+		if (rest <= delta) {
+			*k += kappa;
+			ag_grisu_round(buf, len, delta, rest, ag_pow10_u64[kappa] << -one.e, wp_w);
+			return len;
+		}
+	}
+	for (int kappa = 0;;) {
+		p2 *= 10;
+		delta *= 10;
+		char d = (char)(p2 >> -one.e);
+		if (d || len)
+			buf[len++] = '0' + d;
+		p2 &= one.f - 1;
+		kappa--;
+		if (p2 < delta) {
+			*k += kappa;
+			ag_grisu_round(buf, len, delta, p2, one.f, -kappa < 20 ? wp_w * ag_pow10_u64[-kappa] : 0);
+			return len;
+		}
+	}
+}
+
+// Writes digits of positive finite `v` to `buf`, returns digits count, `v` = digits * 10^`*k`
+static int ag_grisu2(double v, char* buf, int* k) {
+	uint64_t u;
+	memcpy(&u, &v, sizeof(u));
+	int biased_e = (int)((u & AG_DBL_EXP_MASK) >> 52);
+	uint64_t frac = u & AG_DBL_FRAC_MASK;
+	AgDiyFp w = biased_e
+		? (AgDiyFp){ frac + AG_DBL_HIDDEN_BIT, biased_e - AG_DBL_EXP_BIAS }
+		: (AgDiyFp){ frac, 1 - AG_DBL_EXP_BIAS };
+	// Boundaries m+ and m- normalized to the same exponent
+	AgDiyFp plus = { (w.f << 1) + 1, w.e - 1 };
+	while (!(plus.f & (AG_DBL_HIDDEN_BIT << 1))) {
+		plus.f <<= 1;
+		plus.e--;
+	}
+	plus.f <<= 10;  // 64 - 52 - 2
+	plus.e -= 10;
+	AgDiyFp minus = w.f == AG_DBL_HIDDEN_BIT
+		? (AgDiyFp){ (w.f << 2) - 1, w.e - 2 }
+		: (AgDiyFp){ (w.f << 1) - 1, w.e - 1 };
+	minus.f <<= minus.e - plus.e;
+	minus.e = plus.e;
+	// Cached power that brings the product exponent to [-60, -32]
+	double dk = (-61 - plus.e) * 0.30102999566398114 + 347;
+	int ik = (int)dk;
+	if (dk - ik > 0)
+		ik++;
+	int index = (ik >> 3) + 1;
+	*k = -(-348 + index * 8);
+	AgDiyFp c = ag_cached_powers[index];
+	AgDiyFp wc = ag_diy_mul(ag_diy_normalize(w), c);
+	AgDiyFp plus_c = ag_diy_mul(plus, c);
+	AgDiyFp minus_c = ag_diy_mul(minus, c);
+	minus_c.f++;
+	plus_c.f--;
+	return ag_grisu_digits(wc, plus_c, plus_c.f - minus_c.f, buf, k);
+}
+
+int ag_format_double(double v, char* buf) {
+	char* p = buf;
+	uint64_t u;
+	memcpy(&u, &v, sizeof(u));
+	if ((u & AG_DBL_EXP_MASK) == AG_DBL_EXP_MASK) {
+		const char* text = (u & AG_DBL_FRAC_MASK) ? "nan" : (u >> 63) ? "-inf" : "inf";
+		int size = (int)strlen(text);
+		memcpy(buf, text, size);
+		return size;
+	}
+	if (u >> 63) {
+		*p++ = '-';
+		v = -v;
+	}
+	if (v == 0) {
+		*p++ = '0';
+		return (int)(p - buf);
+	}
+	char digits[20];
+	int k;
+	int len = ag_grisu2(v, digits, &k);
+	int point = len + k;  // position of the decimal point relative to the first digit
+	if (point > -6 && point <= 16) {
+		if (point <= 0) {
+			*p++ = '0';
+			*p++ = '.';
+			for (int i = point; i < 0; i++)
+				*p++ = '0';
+			memcpy(p, digits, len);
+			p += len;
+		} else if (point >= len) {
+			memcpy(p, digits, len);
+			p += len;
+			for (int i = len; i < point; i++)
+				*p++ = '0';
+		} else {
+			memcpy(p, digits, point);
+			p += point;
+			*p++ = '.';
+			memcpy(p, digits + point, len - point);
+			p += len - point;
+		}
+	} else {
+		*p++ = digits[0];
+		if (len > 1) {
+			*p++ = '.';
+			memcpy(p, digits + 1, len - 1);
+			p += len - 1;
+		}
+		*p++ = 'e';
+		p += ag_format_int(point - 1, p);
+	}
+	return (int)(p - buf);
+}
+
+static const double ag_pow10_dbl[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+double ag_parse_double(const char* s, const char* end, const char** stop) {
+	const char* p = s;
+	bool neg = p < end && *p == '-';
+	if (p < end && (*p == '-' || *p == '+'))
+		p++;
+	uint64_t mantissa = 0;
+	int digits = 0;      // significant digits in mantissa
+	bool lost = false;   // non-zero digits didn't fit in mantissa
+	int exp10 = 0;
+	const char* start_digits = p;
+	for (; p < end && *p >= '0' && *p <= '9'; p++) {
+		if (digits < 19) {
+			mantissa = mantissa * 10 + (*p - '0');
+			if (mantissa)
+				digits++;
+		} else {
+			exp10++;
+			lost |= *p != '0';
+		}
+	}
+	bool has_digits = p != start_digits;
+	if (p < end && *p == '.') {
+		const char* frac = ++p;
+		for (; p < end && *p >= '0' && *p <= '9'; p++) {
+			if (digits < 19) {
+				mantissa = mantissa * 10 + (*p - '0');
+				if (mantissa)
+					digits++;
+				exp10--;
+			} else {
+				lost |= *p != '0';
+			}
+		}
+		has_digits |= p != frac;
+	}
+	if (!has_digits) {
+		*stop = s;
+		return 0;
+	}
+	if (p < end && (*p == 'e' || *p == 'E')) {
+		const char* e = p + 1;
+		bool exp_neg = e < end && *e == '-';
+		if (e < end && (*e == '-' || *e == '+'))
+			e++;
+		if (e < end && *e >= '0' && *e <= '9') {
+			int exp = 0;
+			for (; e < end && *e >= '0' && *e <= '9'; e++) {
+				if (exp < 100000)
+					exp = exp * 10 + (*e - '0');
+			}
+			exp10 += exp_neg ? -exp : exp;
+			p = e;
+		}
+	}
+	*stop = p;
+	double r;
+	if (!lost && mantissa <= (1ull << 53) && exp10 >= -22 && exp10 <= 22) {
+		// Both operands are exact, so is the correctly rounded result of a single operation
+		r = (double)mantissa;
+		r = exp10 < 0 ? r / ag_pow10_dbl[-exp10] : r * ag_pow10_dbl[exp10];
+	} else if (mantissa == 0 && !lost) {
+		r = 0;
+	} else {
+		char tmp[128];
+		size_t size = p - s;
+		char* text = size < sizeof(tmp) ? tmp : ag_alloc(size + 1);
+		memcpy(text, s, size);
+		text[size] = 0;
+		r = strtod(text, NULL);
+		if (text != tmp)
+			ag_free(text);
+		return r;
+	}
+	return neg ? -r : r;
+}
@@ -0,0 +1,30 @@
+#ifndef AG_NUMBER_H_
+#define AG_NUMBER_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AG_INT_TEXT_MAX 21     // sign and 19 digits
+#define AG_DOUBLE_TEXT_MAX 26  // sign, 17 digits, point, leading zeros or exponent
+
+// Writes decimal `v` to `buf`, returns the number of written chars, no terminating zero.
+int ag_format_int(int64_t v, char* buf);
+
+// Writes the shortest text that parses back to the same `v` (Grisu2), returns the number of written chars.
+// Uses plain notation for 1e-6 <= |v| < 1e16 and `1.5e20` notation otherwise.
+// Integers have no fractional part. Non-finite values are written as `nan`, `inf` and `-inf`.
+int ag_format_double(double v, char* buf);
+
+// Parses [+-]digits[.digits][(e|E)[+-]digits] at `s`, never reads at or beyond `end`.
+// Correctly rounded: short numbers are converted exactly in doubles, others go to strtod.
+// Sets `*stop` to the first unparsed char, which is `s` if there is no number.
+double ag_parse_double(const char* s, const char* end, const char** stop);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif // AG_NUMBER_H_
@@ -1,12 +1,15 @@
 #include <stddef.h> // size_t
 #include <stdint.h> // int32_t int64_t
 #include <stdio.h> // puts
+#include <stdlib.h> // getenv, strtoull
 #include <assert.h>
 #include <time.h>  // timespec, timespec_get
 #include <math.h>  // pow
 
 #include "ag-threads.h"
 #include "utf8.h"
+#include "number.h"
+#include "json-scan.h"
 #include "runtime.h"
 #include "ag-queue.h"
 
@@ -55,6 +58,19 @@ void* ag_alloc(size_t size) {
 	*r = size;
 	return r + 1;
 }
+void* ag_realloc(void* data, size_t size) {
+	if (!data)
+		return ag_alloc(size);
+	size_t* r = (size_t*)data - 1;
+	if ((ag_current_allocated += size - *r) > ag_max_allocated)
+		ag_max_allocated = ag_current_allocated;
+	r = (size_t*)AG_REALLOC(r, size + sizeof(size_t));
+	if (!r) {
+		exit(-42);
+	}
+	*r = size;
+	return r + 1;
+}
 void ag_free(void* data) {
 	if (data) {
 		ag_leak_detector_counter--;
@@ -72,6 +88,13 @@ void* ag_alloc(size_t size) {
 	}
 	return r;
 }
+void* ag_realloc(void* data, size_t size) {
+	void* r = AG_REALLOC(data, size);
+	if (!r) {
+		exit(-42);
+	}
+	return r;
+}
 void ag_free(void* data) {
 	if (data) {
 		AG_FREE(data);
@@ -107,6 +130,7 @@ AG_THREAD_LOCAL uintptr_t* ag_retain_buffer = NULL;
 AG_THREAD_LOCAL uintptr_t* ag_retain_pos;
 AG_THREAD_LOCAL uintptr_t* ag_release_pos;
 pthread_mutex_t            ag_retain_release_mutex;
+pthread_mutex_t            ag_intern_mutex;  // guards interned strings table
 
 void ag_flush_retain_release() {
 	AG_TRACE0("flush [");
@@ -201,9 +225,9 @@ void ag_retain_pin(AgObject* obj) {
 		ag_retain_pin_nn(obj);
 }
 static inline void ag_reg_mt_release(uintptr_t p) {
-	if (--ag_release_pos == ag_retain_pos)
+	*--ag_release_pos = p;
+	if (ag_release_pos == ag_retain_pos)
 		ag_flush_retain_release();
-	*ag_release_pos = p;
 }
 static inline void ag_reg_mt_retain(uintptr_t p) {
 	*ag_retain_pos = p;
@@ -500,24 +524,149 @@ void ag_reg_copy_fixer(AgObject* object, void (*fixer)(AgObject*)) {
 }
 
 int32_t ag_m_sys_Cursor_getCh(AgCursor* s) {
-	return s->pos && *s->pos
-		? get_utf8(&s->pos)
-		: 0;
+	if (s->pos >= s->end)
+		return 0;
+	if ((unsigned char)*s->pos < 0x80)
+		return *s->pos++;
+	return get_utf8(&s->pos);
 }
 int32_t ag_m_sys_Cursor_peekCh(AgCursor* s) {
 	const char* pos = s->pos;
-	return pos && *pos
-		? get_utf8(&pos)
-		: 0;
+	if (pos >= s->end)
+		return 0;
+	if ((unsigned char)*pos < 0x80)
+		return *pos;
+	return get_utf8(&pos);
 }
 int64_t ag_m_sys_Cursor_offset(AgCursor* s) {
 	return s->str ? s->pos - s->str->chars : 0;
 }
+double ag_m_sys_Cursor_parseDouble(AgCursor* s, int64_t from) {
+	if (!s->str || from < 0 || from > s->end - s->str->chars)
+		return 0;
+	const char* stop;
+	double r = ag_parse_double(s->str->chars + from, s->end, &stop);
+	if (stop != s->str->chars + from)
+		s->pos = stop;
+	return r;
+}
+static int ag_put_char(void* ctx, int c) {
+	*(*(char**)ctx)++ = (char)c;
+	return 1;
+}
+// Makes utf8 encoding of `c` in `buf`, returns its size
+static size_t ag_encode_utf8(int32_t c, char* buf) {
+	char* end = buf;
+	put_utf8(c, &end, ag_put_char);
+	return end - buf;
+}
+bool ag_m_sys_Cursor_getSliceTill(AgCursor* s, int32_t separator, AgStringSlice* dst) {
+	if (s->pos >= s->end)
+		return false;
+	char sep[4];
+	size_t sep_size = ag_encode_utf8(separator, sep);
+	const char* found = find_utf8(s->pos, s->end, sep, sep_size);
+	const char* till = found ? found : s->end;
+	ag_m_sys_StringSlice_set(dst, s->str, s->pos - s->str->chars, till - s->str->chars);
+	s->pos = found ? found + sep_size : s->end;
+	return true;
+}
+bool ag_m_sys_Cursor_seekCh(AgCursor* s, int32_t c) {
+	char buf[4];
+	size_t size = ag_encode_utf8(c, buf);
+	const char* found = s->pos < s->end ? find_utf8(s->pos, s->end, buf, size) : NULL;
+	s->pos = found ? found : s->end;
+	return found != NULL;
+}
+bool ag_m_sys_Cursor_seekStr(AgCursor* s, AgString* str) {
+	const char* found = s->pos < s->end ? find_utf8(s->pos, s->end, str->chars, str->size) : NULL;
+	s->pos = found ? found : s->end;
+	return found != NULL;
+}
+void ag_m_sys_Cursor_skipSpaces(AgCursor* s) {
+	if (s->pos < s->end)
+		s->pos = skip_utf8_ws(s->pos, s->end);
+}
+int64_t ag_m_sys_Cursor_runeCount(AgCursor* s) {
+	return s->pos < s->end ? count_utf8(s->pos, s->end) : 0;
+}
+bool ag_m_sys_Cursor_isValidUtf8(AgCursor* s) {
+	return s->pos < s->end ? check_utf8(s->pos, s->end) : true;
+}
+int64_t ag_m_sys_Cursor_skipJsonStr(AgCursor* s) {
+	return s->pos < s->end
+		? ag_json_skip_str(&s->pos, s->end)
+		: AG_JSON_INCOMPLETE_STRING;
+}
+int64_t ag_m_sys_Cursor_skipJsonNested(AgCursor* s, int32_t open) {
+	return s->pos < s->end
+		? ag_json_skip_nested(&s->pos, s->end, (char)open)
+		: open == '{' ? AG_JSON_INCOMPLETE_OBJECT : AG_JSON_INCOMPLETE_ARRAY;
+}
 void ag_m_sys_Cursor_set(AgCursor* th, AgString* s) {
 	ag_retain_shared_nn(&s->head);
 	ag_release_shared(&th->str->head);
 	th->str = s;
 	th->pos = s->chars;
+	th->end = s->chars + s->size;
+}
+void ag_m_sys_Cursor_setSlice(AgCursor* th, AgStringSlice* s) {
+	if (!s->str) {
+		ag_release_shared(&th->str->head);
+		th->str = NULL;
+		th->pos = th->end = NULL;
+		return;
+	}
+	ag_m_sys_Cursor_set(th, s->str);
+	th->pos = s->str->chars + s->start;
+	th->end = s->str->chars + s->end;
+}
+
+void ag_m_sys_StringSlice_set(AgStringSlice* th, AgString* s, int64_t from, int64_t to) {
+	int64_t size = (int64_t)s->size;
+	from = from < 0 ? 0 : from > size ? size : from;
+	to = to < from ? from : to > size ? size : to;
+	ag_retain_shared_nn(&s->head);
+	ag_release_shared(&th->str->head);
+	th->str = s;
+	th->start = from;
+	th->end = to;
+}
+void ag_m_sys_StringSlice_fromCursor(AgStringSlice* th, AgCursor* c, int64_t from, int64_t to) {
+	if (c->str) {
+		ag_m_sys_StringSlice_set(th, c->str, from, to);
+	} else {
+		ag_release_shared(&th->str->head);
+		th->str = NULL;
+		th->start = th->end = 0;
+	}
+}
+int64_t ag_m_sys_StringSlice_size(AgStringSlice* th) {
+	return th->end - th->start;
+}
+bool ag_m_sys_StringSlice_equalsStr(AgStringSlice* th, AgString* s) {
+	size_t size = th->end - th->start;
+	return s->size == size && (!size || memcmp(th->str->chars + th->start, s->chars, size) == 0);
+}
+AgString* ag_m_sys_StringSlice_toStr(AgStringSlice* th) {
+	if (!th->str)
+		return ag_make_str("", 0);
+	if (th->start == 0 && th->end == (int64_t)th->str->size) {
+		ag_retain_shared_nn(&th->str->head);
+		return th->str;
+	}
+	return ag_make_str(th->str->chars + th->start, th->end - th->start);
+}
+int64_t ag_m_sys_StringSlice_getHash(AgObject* obj) {
+	AgStringSlice* s = (AgStringSlice*)obj;
+	return s->str ? ag_getStringHash(s->str->chars + s->start, s->end - s->start) : ag_getStringHash("", 0);
+}
+bool ag_m_sys_StringSlice_equals(AgObject* a, AgObject* b) {
+	AgStringSlice* sa = (AgStringSlice*)a;
+	AgStringSlice* sb = (AgStringSlice*)b;
+	size_t size = sa->end - sa->start;
+	return size == (size_t)(sb->end - sb->start) &&
+		(!size || memcmp(sa->str->chars + sa->start, sb->str->chars + sb->start, size) == 0);
 }
 
 double ag_fn_sys_powDbl(double v, double p) { return pow(v, p); }
@@ -538,7 +687,7 @@ void ag_fn_sys_terminate(int result) {
 }
 
 void ag_fn_sys_log(AgString* s) {
-	fputs(s->chars, stdout);
+	fwrite(s->chars, 1, s->size, stdout);
 }
 uint64_t ag_fn_sys_nowMs() {
 	struct timespec now;
@@ -553,12 +702,144 @@ int64_t ag_fn_sys_hash(AgObject* obj) {  // Shared
 		? &obj->wb_p
 		: &((AgWeak*)obj->wb_p)->org_pointer_to_parent;
 	if ((obj->ctr_mt & AG_CTR_HASH) == 0) {
+		*dst = ((AgVmt*)(ag_head(obj)->dispatcher))[-1].get_hash(obj) | 1;  // before the flag, other threads can check it
 		obj->ctr_mt |= AG_CTR_HASH;
-		*dst = ((AgVmt*)(ag_head(obj)->dispatcher))[-1].get_hash(obj) | 1;
 	}
 	return *dst >> 1;
 }
 
+// Field name lookup for `@json` classes.
+// The perfect hash depends on the per process `ag_hash_seed`, so it is built at the first lookup
+// and cached per thread (without locks) by the address of the `names` literal.
+typedef struct {
+	size_t  start, size;  // position in `names`
+	int64_t hash;         // as returned by ag_fn_sys_hash
+} AgKeyName;
+typedef struct {
+	AgString*  names;
+	size_t     count;
+	uint64_t   mul;    // slot = hash * mul >> shift, 0 if no perfect hash found and names are checked one by one
+	int        shift;
+	int32_t*   slots;  // name index or -1
+	AgKeyName  list[1];
+} AgKeyIndex;
+
+AG_THREAD_LOCAL AgKeyIndex** ag_key_indices = NULL;  // open addressing by `names` address
+AG_THREAD_LOCAL size_t       ag_key_indices_capacity = 0;
+AG_THREAD_LOCAL size_t       ag_key_indices_count = 0;
+
+static AgKeyIndex* ag_make_key_index(AgString* names) {
+	size_t count = 1;
+	for (size_t i = 0; i < names->size; i++)
+		count += names->chars[i] == ' ';
+	AgKeyIndex* r = (AgKeyIndex*)AG_ALLOC(sizeof(AgKeyIndex) + sizeof(AgKeyName) * (count - 1));
+	r->names = names;
+	r->count = count;
+	r->mul = 0;
+	r->slots = NULL;
+	for (size_t i = 0, start = 0; i < count; i++) {
+		size_t end = start;
+		while (end < names->size && names->chars[end] != ' ')
+			end++;
+		r->list[i].start = start;
+		r->list[i].size = end - start;
+		r->list[i].hash = (ag_getStringHash(names->chars + start, end - start) | 1) >> 1;
+		start = end + 1;
+	}
+	for (int bits = 1; bits <= 16 && !r->mul; bits++) {
+		size_t slots_count = (size_t)1 << bits;
+		if (slots_count < count)
+			continue;
+		r->slots = (int32_t*)AG_REALLOC(r->slots, sizeof(int32_t) * slots_count);
+		uint64_t candidate = ag_hash_seed ^ AG_HASH_SECRET0;
+		for (int attempt = 0; attempt < 100 && !r->mul; attempt++) {
+			uint64_t mul = candidate | 1;
+			memset(r->slots, -1, sizeof(int32_t) * slots_count);
+			size_t i = 0;
+			for (; i < count; i++) {
+				int32_t* slot = r->slots + ((uint64_t)r->list[i].hash * mul >> (64 - bits));
+				if (*slot >= 0)
+					break;
+				*slot = (int32_t)i;
+			}
+			if (i == count) {
+				r->mul = mul;
+				r->shift = 64 - bits;
+			}
+			candidate = candidate * 6364136223846793005ull + 1442695040888963407ull;
+		}
+	}
+	return r;
+}
+static void ag_free_key_index(AgKeyIndex* ki) {
+	AG_FREE(ki->slots);
+	AG_FREE(ki);
+}
+static void ag_free_key_indices() {
+	for (size_t i = 0; i < ag_key_indices_capacity; i++) {
+		if (ag_key_indices[i])
+			ag_free_key_index(ag_key_indices[i]);
+	}
+	AG_FREE(ag_key_indices);
+	ag_key_indices = NULL;
+	ag_key_indices_capacity = ag_key_indices_count = 0;
+}
+static AgKeyIndex** ag_find_key_index(AgString* names) {
+	for (size_t i = ((uintptr_t)names >> 4) * AG_HASH_SECRET1 >> 32;; i++) {
+		AgKeyIndex** r = ag_key_indices + (i & (ag_key_indices_capacity - 1));
+		if (!*r || (*r)->names == names)
+			return r;
+	}
+}
+static AgKeyIndex* ag_get_key_index(AgString* names) {
+	if (ag_key_indices_count) {
+		AgKeyIndex* r = *ag_find_key_index(names);
+		if (r)
+			return r;
+	}
+	if ((ag_key_indices_count + 1) * 2 > ag_key_indices_capacity) {
+		AgKeyIndex** old = ag_key_indices;
+		size_t old_capacity = ag_key_indices_capacity;
+		ag_key_indices_capacity = old_capacity ? old_capacity * 2 : 16;
+		ag_key_indices = (AgKeyIndex**)AG_ALLOC(sizeof(AgKeyIndex*) * ag_key_indices_capacity);
+		ag_zero_mem(ag_key_indices, sizeof(AgKeyIndex*) * ag_key_indices_capacity);
+		for (size_t i = 0; i < old_capacity; i++) {
+			if (old[i])
+				*ag_find_key_index(old[i]->names) = old[i];
+		}
+		AG_FREE(old);
+	}
+	ag_key_indices_count++;
+	return *ag_find_key_index(names) = ag_make_key_index(names);
+}
+static bool ag_key_name_is(AgKeyIndex* ki, size_t i, AgString* key, int64_t hash) {
+	AgKeyName* n = ki->list + i;
+	return n->hash == hash && n->size == key->size && memcmp(ki->names->chars + n->start, key->chars, n->size) == 0;
+}
+int64_t ag_fn_sys_keyIndex(AgString* key, AgString* names) {
+	if (!key || !names)
+		return -1;
+	bool is_literal = names->head.ctr_mt < AG_CTR_STEP;  // others can die and leave their address to other strings
+	AgKeyIndex* ki = is_literal
+		? ag_get_key_index(names)
+		: ag_make_key_index(names);
+	int64_t hash = ag_fn_sys_hash(&key->head);
+	int64_t r = -1;
+	if (ki->mul) {
+		int32_t i = ki->slots[(uint64_t)hash * ki->mul >> ki->shift];
+		if (i >= 0 && ag_key_name_is(ki, i, key, hash))
+			r = i;
+	} else {
+		for (size_t i = 0; i < ki->count && r < 0; i++) {
+			if (ag_key_name_is(ki, i, key, hash))
+				r = i;
+		}
+	}
+	if (!is_literal)
+		ag_free_key_index(ki);
+	return r;
+}
+
 bool ag_eq_mut(AgObject* a, AgObject* b) {
 	if (a == b) return true;
 	if (!a || !b) return false;
@@ -591,10 +872,13 @@ bool ag_m_sys_Object_equals(AgObject* a, AgObject* b) {
 }
 
 int64_t ag_m_sys_String_getHash(AgObject* obj) {
-	return ag_getStringHash(((AgString*)obj)->chars);
+	AgString* s = (AgString*)obj;
+	return ag_getStringHash(s->chars, s->size);
 }
 bool ag_m_sys_String_equals(AgObject* a, AgObject* b) {
-	return strcmp(((AgString*)a)->chars, ((AgString*)b)->chars) == 0;
+	AgString* sa = (AgString*)a;
+	AgString* sb = (AgString*)b;
+	return sa == sb || (sa->size == sb->size && memcmp(sa->chars, sb->chars, sa->size) == 0);
 }
 
 static void ag_init_thread(ag_thread* th) {
@@ -740,6 +1024,7 @@ void ag_init_this_thread() {
 	if (ag_current_thread == &ag_main_thread) {
 		pthread_mutex_init(&ag_retain_release_mutex, NULL);
 		pthread_mutex_init(&ag_threads_mutex, NULL);
+		pthread_mutex_init(&ag_intern_mutex, NULL);
 	}
 }
 
@@ -832,6 +1117,7 @@ void* ag_thread_proc(ag_thread* th) {
 	}
 	pthread_mutex_unlock(&th->mutex);
 	ag_maybe_flush_retain_release();
+	ag_free_key_indices();
 	AG_TRACE0("thread_proc]");
 	return NULL;
 }
@@ -906,8 +1192,20 @@ void ag_visit_sys_Thread(
 	void* ctx)
 {}
 
+uint64_t ag_hash_seed = 0;
+
 void ag_init() {
 	ag_current_thread = &ag_main_thread;
+	const char* seed = getenv("AG_HASH_SEED");
+	if (seed) {
+		ag_hash_seed = strtoull(seed, NULL, 0);
+	} else {
+		struct timespec now;
+		timespec_get(&now, TIME_UTC);
+		ag_hash_seed = ag_hash_mix(
+			((uint64_t)now.tv_sec * 1000000000ull + now.tv_nsec) ^ AG_HASH_SECRET2,
+			(uint64_t)(uintptr_t)&now ^ (uint64_t)(uintptr_t)&ag_hash_seed ^ AG_HASH_SECRET3);  // + ASLR
+	}
 }
 
 // Used by FFI, not by Ag
@@ -966,11 +1264,155 @@ void ag_detach_weak(AgWeak* w) {
 
 AgString* ag_make_str(const char* start, size_t size) {
 	AgString* s = (AgString*)ag_allocate_obj(sizeof(AgString) + size);
+	s->size = size;
 	ag_memcpy(s->chars, start, size);
 	s->chars[size] = 0;
 	s->head.dispatcher = ag_disp_sys_String;
 	s->head.ctr_mt |= AG_CTR_SHARED | AG_CTR_HASH;
-	s->head.wb_p = ag_getStringHash(s->chars) | 1;
-	// TODO: combine hash calc and copy
+	s->head.wb_p = ag_getStringHash(s->chars, size) | 1;
 	return s;
 }
+
+// Interned strings table, guarded by its own mutex.
+// The table holds a counted reference to each interned string, so releases in `ag_flush_retain_release` don't
+// check the table. Interned strings are mt, their counters change only under ag_retain_release_mutex,
+// the table takes it after `ag_intern_mutex` to retain found strings and to sweep strings referenced
+// only by the table. Sweeps happen before the table grows and when statistics are queried.
+typedef struct {
+	uint64_t  hash;  // cached hash from string header
+	AgString* str;   // NULL - empty, AG_INTERN_DELETED - deleted
+} AgInternSlot;
+#define AG_INTERN_DELETED ((AgString*)1)
+AgInternSlot* ag_intern_slots = NULL;
+uint64_t      ag_intern_capacity = 0;  // 0 or power of 2
+uint64_t      ag_intern_count = 0;
+uint64_t      ag_intern_used = 0;      // live and deleted
+uint64_t      ag_intern_bytes = 0;     // in live strings
+uint64_t      ag_intern_lookups = 0;
+uint64_t      ag_intern_hits = 0;
+
+// Returns slot with equal string or the first free slot in the probe sequence.
+static AgInternSlot* ag_intern_find(uint64_t hash, const char* chars, size_t size) {
+	AgInternSlot* free_slot = NULL;
+	for (uint64_t i = hash >> 7;; i++) {
+		AgInternSlot* slot = ag_intern_slots + (i & (ag_intern_capacity - 1));
+		if (!slot->str)
+			return free_slot ? free_slot : slot;
+		if (slot->str == AG_INTERN_DELETED) {
+			if (!free_slot)
+				free_slot = slot;
+		} else if (slot->hash == hash && slot->str->size == size && memcmp(slot->str->chars, chars, size) == 0) {
+			return slot;
+		}
+	}
+}
+// Removes strings referenced only by the table, must be called under ag_intern_mutex.
+static void ag_intern_sweep() {
+	AgObject* root = NULL;
+	pthread_mutex_lock(&ag_retain_release_mutex);
+	for (AgInternSlot* i = ag_intern_slots, *e = i + ag_intern_capacity; i < e; i++) {
+		if (i->str <= AG_INTERN_DELETED)
+			continue;
+		AgObject* obj = &i->str->head;
+		if (obj->ctr_mt < AG_CTR_STEP || obj->ctr_mt >= AG_CTR_STEP * 2)  // literal or used
+			continue;
+		ag_intern_count--;
+		ag_intern_bytes -= sizeof(AgString) + i->str->size;
+		i->str = AG_INTERN_DELETED;
+		obj->ctr_mt = (intptr_t)root;
+		root = obj;
+	}
+	pthread_mutex_unlock(&ag_retain_release_mutex);
+	while (root) {
+		AgObject* n = AG_UNTAG_PTR(AgObject, root->ctr_mt);
+		ag_dispose_obj(root);
+		root = n;
+	}
+}
+static void ag_intern_reserve() {
+	if ((ag_intern_used + 1) * 2 <= ag_intern_capacity)
+		return;
+	ag_intern_sweep();
+	AgInternSlot* old = ag_intern_slots;
+	uint64_t old_capacity = ag_intern_capacity;
+	while ((ag_intern_count + 1) * 4 > ag_intern_capacity)  // leaves room for deleted slots to not rebuild the table too often
+		ag_intern_capacity = ag_intern_capacity ? ag_intern_capacity * 2 : 64;
+	ag_intern_slots = (AgInternSlot*)ag_alloc(sizeof(AgInternSlot) * ag_intern_capacity);
+	ag_zero_mem(ag_intern_slots, sizeof(AgInternSlot) * ag_intern_capacity);
+	ag_intern_used = ag_intern_count;
+	for (AgInternSlot* i = old, *e = old + old_capacity; i < e; i++) {
+		if (i->str > AG_INTERN_DELETED)
+			*ag_intern_find(i->hash, i->str->chars, i->str->size) = *i;
+	}
+	ag_free(old);
+}
+// Must be called under ag_intern_mutex, `s` must be not interned yet.
+static void ag_intern_add(AgInternSlot* slot, uint64_t hash, AgString* s) {
+	if (!slot->str)
+		ag_intern_used++;
+	slot->hash = hash;
+	slot->str = s;
+	ag_intern_count++;
+	ag_intern_bytes += sizeof(AgString) + s->size;
+}
+// Adds `steps` references to `s` that can be owned by other threads.
+static void ag_intern_retain(AgString* s, intptr_t steps) {
+	if (s->head.ctr_mt < AG_CTR_STEP)  // literal
+		return;
+	if ((s->head.ctr_mt & AG_CTR_MT) == 0) {  // it belongs only to this thread, so no lock here
+		s->head.ctr_mt = (s->head.ctr_mt | AG_CTR_MT) + AG_CTR_STEP * steps;
+		return;
+	}
+	pthread_mutex_lock(&ag_retain_release_mutex);
+	s->head.ctr_mt += AG_CTR_STEP * steps;
+	pthread_mutex_unlock(&ag_retain_release_mutex);
+}
+// Returns retained interned string equal to `chars`.
+// If there is none, interns `str` or a new string if `str` is NULL.
+static AgString* ag_intern_chars(const char* chars, size_t size, AgString* str) {
+	uint64_t hash = (uint64_t)ag_getStringHash(chars, size) | 1;
+	ag_init_this_thread();
+	pthread_mutex_lock(&ag_intern_mutex);
+	ag_intern_reserve();
+	ag_intern_lookups++;
+	AgInternSlot* slot = ag_intern_find(hash, chars, size);
+	AgString* r = slot->str > AG_INTERN_DELETED ? slot->str : NULL;
+	if (r) {
+		ag_intern_hits++;
+		ag_intern_retain(r, 1);
+	} else if (str) {
+		ag_intern_retain(str, 2);  // result and table
+		ag_intern_add(slot, hash, str);
+		r = str;
+	} else {
+		r = ag_make_str(chars, size);
+		ag_intern_retain(r, 1);  // table
+		ag_intern_add(slot, hash, r);
+	}
+	pthread_mutex_unlock(&ag_intern_mutex);
+	return r;
+}
+AgString* ag_make_interned_str(const char* start, size_t size) {
+	return ag_intern_chars(start, size, NULL);
+}
+AgString* ag_fn_sys_intern(AgString* s) {
+	return ag_intern_chars(s->chars, s->size, s);
+}
+// Applies this thread pending releases and sweeps the table to count only used strings.
+static void ag_intern_sweep_used() {
+	ag_init_this_thread();
+	ag_maybe_flush_retain_release();
+	pthread_mutex_lock(&ag_intern_mutex);
+	ag_intern_sweep();
+	pthread_mutex_unlock(&ag_intern_mutex);
+}
+int64_t ag_fn_sys_internedCount() {
+	ag_intern_sweep_used();
+	return ag_intern_count;
+}
+int64_t ag_fn_sys_internedBytes() {
+	ag_intern_sweep_used();
+	return ag_intern_bytes + ag_intern_capacity * sizeof(AgInternSlot);
+}
+int64_t ag_fn_sys_internLookups() { return ag_intern_lookups; }
+int64_t ag_fn_sys_internHits() { return ag_intern_hits; }
@@ -21,7 +21,13 @@ typedef int bool;
 #define AG_FREE free
 #endif
 
+#ifndef AG_REALLOC  // custom AG_ALLOC/AG_FREE not compatible with malloc must define it too
+#include <stdlib.h>
+#define AG_REALLOC realloc
+#endif
+
 void* ag_alloc(size_t size);
+void* ag_realloc(void* data, size_t size);  // keeps content, size must be > 0
 void ag_free(void* data);
 
 #ifdef NO_DEFAULT_LIB
@@ -99,8 +105,10 @@ typedef struct {
 	ag_thread* thread;       // pointer to ag_thread struct
 } AgWeak;
 
+// Mirrored by string literals in the generator: header, size, chars.
 typedef struct {
 	AgObject head;
+	uint64_t size;        // in bytes, without terminating zero
 	char     chars[1];    // variable size zero terminated utf8
 } AgString;
 
@@ -108,8 +116,17 @@ typedef struct {
 	AgObject head;
 	const char* pos;
 	AgString*   str; // shared
+	const char* end; // for slices, otherwise points to terminating zero
 } AgCursor;
 
+// View of bytes [start, end) of a shared string, it keeps the string alive without copying.
+typedef struct {
+	AgObject  head;
+	AgString* str; // shared
+	int64_t   start;
+	int64_t   end;
+} AgStringSlice;
+
 typedef struct {
 	AgObject              head;
 	struct ag_thread_tag* thread;
@@ -175,15 +192,115 @@ int64_t   ag_m_sys_String_getHash   (AgObject* obj);
 bool      ag_m_sys_String_equals    (AgObject* a, AgObject* b);
 
 void      ag_m_sys_Cursor_set(AgCursor* th, AgString* s);
+void      ag_m_sys_Cursor_setSlice(AgCursor* th, AgStringSlice* s);
 int32_t   ag_m_sys_Cursor_getCh(AgCursor* s);
 int32_t   ag_m_sys_Cursor_peekCh(AgCursor* s);
 int64_t   ag_m_sys_Cursor_offset(AgCursor* s);
+double    ag_m_sys_Cursor_parseDouble(AgCursor* s, int64_t from);  // moves cursor past the number
+// Bulk scanners, they work on bytes [pos, end) without decoding every code point
+bool      ag_m_sys_Cursor_getSliceTill(AgCursor* s, int32_t separator, AgStringSlice* dst);  // skips the separator
+bool      ag_m_sys_Cursor_seekCh     (AgCursor* s, int32_t c);     // stops at `c` or at the end if not found
+bool      ag_m_sys_Cursor_seekStr    (AgCursor* s, AgString* str); // stops at `str` or at the end if not found
+void      ag_m_sys_Cursor_skipSpaces (AgCursor* s);
+int64_t   ag_m_sys_Cursor_runeCount  (AgCursor* s);
+bool      ag_m_sys_Cursor_isValidUtf8(AgCursor* s);
+// JSON scanners, cursor is past the opening quote or bracket, return AG_JSON_* codes from json-scan.h
+int64_t   ag_m_sys_Cursor_skipJsonStr   (AgCursor* s);
+int64_t   ag_m_sys_Cursor_skipJsonNested(AgCursor* s, int32_t open);
+
+int64_t   ag_m_sys_StringSlice_getHash   (AgObject* obj);
+bool      ag_m_sys_StringSlice_equals    (AgObject* a, AgObject* b);
+void      ag_m_sys_StringSlice_set       (AgStringSlice* th, AgString* s, int64_t from, int64_t to);
+void      ag_m_sys_StringSlice_fromCursor(AgStringSlice* th, AgCursor* c, int64_t from, int64_t to);
+int64_t   ag_m_sys_StringSlice_size      (AgStringSlice* th);
+bool      ag_m_sys_StringSlice_equalsStr (AgStringSlice* th, AgString* s);
+AgString* ag_m_sys_StringSlice_toStr     (AgStringSlice* th);  // shares the string if slice covers it entirely
 
-static inline int64_t ag_getStringHash(const char* s) {
-	int64_t r = 5381;
-	for (; *s; s++)
-		r = ((r << 5) + r) ^ *s;
-	return r;
+//
+// String hashing
+// Strings cache their hashes in headers, literals do it on the first `ag_fn_sys_hash` call.
+// String hash is keyed with the per process `ag_hash_seed`, so colliding keys can't be crafted in advance.
+//
+#define AG_HASH_SECRET0 0xa0761d6478bd642full
+#define AG_HASH_SECRET1 0xe7037ed1a0b428dbull
+#define AG_HASH_SECRET2 0x8ebc6af09c88c6dbull
+#define AG_HASH_SECRET3 0x589965cc75374cc3ull
+
+extern uint64_t ag_hash_seed;  // random per process or taken from AG_HASH_SEED environment variable
+
+// 64x64->128 multiplication, replaces `a` and `b` with low and high halves of the product
+static inline void ag_hash_mum(uint64_t* a, uint64_t* b) {
+#if defined(__SIZEOF_INT128__)
+	__uint128_t r = (__uint128_t)*a * *b;
+	*a = (uint64_t)r;
+	*b = (uint64_t)(r >> 64);
+#else
+	uint64_t ha = *a >> 32, la = (uint32_t)*a, hb = *b >> 32, lb = (uint32_t)*b;
+	uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+	uint64_t t = rl + (rm0 << 32);
+	uint64_t lo = t + (rm1 << 32);
+	*b = rh + (rm0 >> 32) + (rm1 >> 32) + (t < rl) + (lo < t);
+	*a = lo;
+#endif
+}
+static inline uint64_t ag_hash_mix(uint64_t a, uint64_t b) {
+	ag_hash_mum(&a, &b);
+	return a ^ b;
+}
+// Byte order independent loads, compilers turn them into single moves
+static inline uint64_t ag_hash_read8(const unsigned char* p) {
+	return (uint64_t)p[0] | (uint64_t)p[1] << 8 | (uint64_t)p[2] << 16 | (uint64_t)p[3] << 24 |
+		(uint64_t)p[4] << 32 | (uint64_t)p[5] << 40 | (uint64_t)p[6] << 48 | (uint64_t)p[7] << 56;
+}
+static inline uint64_t ag_hash_read4(const unsigned char* p) {
+	return (uint64_t)p[0] | (uint64_t)p[1] << 8 | (uint64_t)p[2] << 16 | (uint64_t)p[3] << 24;
+}
+// Wyhash-style hash processing 48 bytes per iteration
+static inline int64_t ag_getStringHash(const char* str, size_t size) {
+	const unsigned char* p = (const unsigned char*)str;
+	uint64_t k1 = AG_HASH_SECRET1 ^ ag_hash_seed;  // data is xored with keys, otherwise a block equal to a public secret zeroes the state
+	uint64_t k2 = AG_HASH_SECRET2 ^ ag_hash_seed;
+	uint64_t k3 = AG_HASH_SECRET3 ^ ag_hash_seed;
+	uint64_t seed = ag_hash_mix(AG_HASH_SECRET0 ^ ag_hash_seed, k1);
+	uint64_t a, b;
+	if (size <= 16) {
+		if (size >= 4) {
+			size_t mid = (size >> 3) << 2;
+			a = ag_hash_read4(p) << 32 | ag_hash_read4(p + mid);
+			b = ag_hash_read4(p + size - 4) << 32 | ag_hash_read4(p + size - 4 - mid);
+		} else if (size > 0) {
+			a = (uint64_t)p[0] << 16 | (uint64_t)p[size >> 1] << 8 | p[size - 1];
+			b = 0;
+		} else {
+			a = b = 0;
+		}
+	} else {
+		size_t i = size;
+		if (i > 48) {
+			uint64_t see1 = seed, see2 = seed;
+			do {
+				seed = ag_hash_mix(ag_hash_read8(p) ^ k1, ag_hash_read8(p + 8) ^ seed);
+				see1 = ag_hash_mix(ag_hash_read8(p + 16) ^ k2, ag_hash_read8(p + 24) ^ see1);
+				see2 = ag_hash_mix(ag_hash_read8(p + 32) ^ k3, ag_hash_read8(p + 40) ^ see2);
+				p += 48;
+				i -= 48;
+			} while (i > 48);
+			seed ^= see1 ^ see2;
+		}
+		for (; i > 16; i -= 16, p += 16)
+			seed = ag_hash_mix(ag_hash_read8(p) ^ k1, ag_hash_read8(p + 8) ^ seed);
+		a = ag_hash_read8(p + i - 16);
+		b = ag_hash_read8(p + i - 8);
+	}
+	a ^= k1;
+	b ^= seed;
+	ag_hash_mum(&a, &b);
+	return (int64_t)ag_hash_mix(a ^ AG_HASH_SECRET0 ^ size, b ^ AG_HASH_SECRET1);
+}
+// Byte-wise three-way comparison, consistent with strcmp for strings without embedded zeroes
+static inline int ag_compare_strings(AgString* a, AgString* b) {
+	int r = memcmp(a->chars, b->chars, a->size < b->size ? a->size : b->size);
+	return r ? r : (a->size > b->size) - (a->size < b->size);
 }
 //
 // System
@@ -191,7 +308,13 @@ static inline int64_t ag_getStringHash(const char* s) {
 void      ag_fn_sys_terminate     (int);
 bool      ag_fn_sys_setMainObject (AgObject* root); // root must be not owned, returns true on success
 void      ag_fn_sys_log           (AgString* s);
+AgString* ag_fn_sys_intern        (AgString* s);  // returns the interned string equal to `s`, interns `s` if there is none
+int64_t   ag_fn_sys_internedCount ();  // of strings used outside the table
+int64_t   ag_fn_sys_internedBytes ();  // in interned strings and in the table
+int64_t   ag_fn_sys_internLookups ();
+int64_t   ag_fn_sys_internHits    ();
 int64_t   ag_fn_sys_hash          (AgObject* s);
+int64_t   ag_fn_sys_keyIndex      (AgString* key, AgString* names);  // index of `key` in space separated `names` literal or -1
 uint64_t  ag_fn_sys_nowMs         ();
 
 //
@@ -261,6 +384,9 @@ void     ag_unlock_thread_queue (ag_thread* th);
 
 // Returns immutable shared string
 AgString* ag_make_str(const char* start, size_t size);
+// Same but reuses the interned string with the same content, or interns the new one.
+// Interned strings are held by a process-wide table till they are unused, they are mt and can be passed to any thread.
+AgString* ag_make_interned_str(const char* start, size_t size);
 
 int ag_handle_main_thread();
 
@@ -1,3 +1,4 @@
+#include <string.h>  // memchr, memcmp, memcpy
 #include "utf8.h"
 
 int get_utf8_no_surrogates(const char** ptr) {
@@ -69,3 +70,83 @@ int put_utf8(int v, void* ctx, int(*put_fn)(void*, int)) {
 		return r;
 	}
 }
+
+#define AG_UTF8_HIGH_BITS 0x8080808080808080ull
+
+static uint64_t load8(const char* p) {
+	uint64_t r;
+	memcpy(&r, p, sizeof(r));
+	return r;
+}
+
+int check_utf8(const char* s, const char* end) {
+	const unsigned char* p = (const unsigned char*)s;
+	const unsigned char* e = (const unsigned char*)end;
+	while (p < e) {
+		if (e - p >= 8 && (load8((const char*)p) & AG_UTF8_HIGH_BITS) == 0) {
+			p += 8;
+			continue;
+		}
+		unsigned c = *p++;
+		if (c < 0x80)
+			continue;
+		int n;
+		unsigned min;
+		if ((c & 0xe0) == 0xc0) n = 1, min = 0x80, c &= 0x1f;
+		else if ((c & 0xf0) == 0xe0) n = 2, min = 0x800, c &= 0xf;
+		else if ((c & 0xf8) == 0xf0) n = 3, min = 0x10000, c &= 7;
+		else
+			return 0;
+		if (e - p < n)
+			return 0;
+		for (; n; n--, p++) {
+			if ((*p & 0xc0) != 0x80)
+				return 0;
+			c = c << 6 | (*p & 0x3f);
+		}
+		if (c < min || c > 0x10ffff || (c >= 0xd800 && c <= 0xdfff))
+			return 0;
+	}
+	return 1;
+}
+
+int64_t count_utf8(const char* s, const char* end) {
+	int64_t r = 0;
+	for (; end - s >= 8; s += 8) {
+		uint64_t w = load8(s);
+		// high bit of each continuation byte 10xxxxxx
+		uint64_t cont = w & ~(w << 1) & AG_UTF8_HIGH_BITS;
+		r += 8 - (int64_t)(((cont >> 7) * 0x0101010101010101ull) >> 56);
+	}
+	for (; s < end; s++)
+		r += (*s & 0xc0) != 0x80;
+	return r;
+}
+
+const char* find_utf8(const char* s, const char* end, const char* what, size_t what_size) {
+	if (!what_size)
+		return s;
+	while ((size_t)(end - s) >= what_size) {
+		s = memchr(s, what[0], end - s - what_size + 1);
+		if (!s)
+			return NULL;
+		if (memcmp(s, what, what_size) == 0)
+			return s;
+		s++;
+	}
+	return NULL;
+}
+
+const char* skip_utf8_ws(const char* s, const char* end) {
+	for (; end - s >= 8; s += 8) {
+		uint64_t w = load8(s);
+		// all bytes are in 1..0x20 if neither of them is zero nor above 0x20
+		uint64_t zero = (w - 0x0101010101010101ull) & ~w & AG_UTF8_HIGH_BITS;
+		uint64_t above = (((w & 0x7f7f7f7f7f7f7f7full) + 0x5f5f5f5f5f5f5f5full) | w) & AG_UTF8_HIGH_BITS;
+		if (zero | above)
+			break;
+	}
+	while (s < end && *s > 0 && *s <= ' ')
+		s++;
+	return s;
+}
@@ -1,6 +1,9 @@
 #ifndef AK_UTF8_H__
 #define AK_UTF8_H__
 
+#include <stddef.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -8,6 +11,12 @@ extern "C" {
 int get_utf8(const char** ptr);
 int put_utf8(int v, void* ctx, int(*put_fn)(void*, int));
 
+// Bulk scanners of [s, end), they process 8 ASCII bytes at a time.
+int         check_utf8  (const char* s, const char* end);  // 1 if well-formed: no overlongs, surrogates or truncated sequences
+int64_t     count_utf8  (const char* s, const char* end);  // number of code points, continuation bytes are not counted
+const char* find_utf8   (const char* s, const char* end, const char* what, size_t what_size);  // NULL if not found
+const char* skip_utf8_ws(const char* s, const char* end);  // skips bytes 1..0x20
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
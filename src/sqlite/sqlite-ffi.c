@@ -73,7 +73,7 @@ void ag_m_sqliteFfi_Row_sqliteFfi_blobAt(AgSqliteQuery* q, int at, AgBlob* resul
 }
 
 AgSqliteQuery* ag_m_sqliteFfi_Query_sqliteFfi_setString(AgSqliteQuery* q, int at, AgString* val) {
-    sqlite3_bind_text(q->stmt, at, val->chars, (int) strlen(val->chars), SQLITE_TRANSIENT);  // TODO: optimize after String/Cursor refactoring
+    sqlite3_bind_text(q->stmt, at, val->chars, (int) val->size, SQLITE_TRANSIENT);
     ag_retain_pin_nn(&q->header);
     return q;
 }